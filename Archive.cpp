@@ -0,0 +1,305 @@
+/*******************************************************************************
+ Filename:                  Archive.cpp
+ Classname:                 Archive
+
+ Description:               This file defines the Archive class.
+ ******************************************************************************/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <sys/stat.h>
+
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+#include "Archive.h"
+#include "Lz4.h"
+
+const char MAGIC[]     = "APAK";
+const int  HEADER_SIZE = 28;
+
+static Uint32 read16(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static Uint32 read32(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+/*******************************************************************************
+ Name:              Archive
+ Description:       Constructor. Nothing is open.
+ ******************************************************************************/
+Archive::Archive()
+{
+    data      = NULL;
+    size      = 0;
+    numLoads  = 0;
+    bytesRead = 0;
+    numStale  = 0;
+    lock      = SDL_CreateMutex();
+
+    masks[0] = masks[1] = masks[2] = 0;
+}
+
+Archive::~Archive()
+{
+    close();
+    SDL_DestroyMutex(lock);
+}
+
+/*******************************************************************************
+ Name:              open
+ Description:       Maps an archive and reads its index. An archive already
+                    open is closed first.
+
+ Input:
+    path            The .pak file
+
+ Output:
+    returns         false if it is missing or not an archive
+ ******************************************************************************/
+bool Archive::open(const char* path)
+{
+    close();
+
+    if(!mapFile(path))
+        return false;
+
+    if(!readIndex())
+    {
+        cout << path << ": not an image archive" << endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              mapFile
+ Description:       Maps the whole file read only. The view outlives the
+                    file handles, which are closed at once.
+ ******************************************************************************/
+bool Archive::mapFile(const char* path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER length;
+    HANDLE        mapping = NULL;
+
+    if(GetFileSizeEx(file, &length) && length.QuadPart > 0)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if(mapping)
+    {
+        data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        size = data ? (size_t)length.QuadPart : 0;
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+#else
+    int fd = ::open(path, O_RDONLY);
+
+    if(fd < 0)
+        return false;
+
+    struct stat info;
+
+    if(fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void* p = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(p != MAP_FAILED)
+        {
+            data = (const unsigned char*)p;
+            size = (size_t)info.st_size;
+        }
+    }
+
+    ::close(fd);
+#endif
+
+    return data != NULL;
+}
+
+/*******************************************************************************
+ Name:              readIndex
+ Description:       Reads the header and the entry for every image, checking
+                    each lies inside the file
+
+ Output:
+    returns         false if the file is not an archive this version reads
+ ******************************************************************************/
+bool Archive::readIndex()
+{
+    if(size < (size_t)HEADER_SIZE || memcmp(data, MAGIC, 4) != 0
+       || read32(data + 4) != VERSION || read32(data + 12) != 32)
+        return false;
+
+    Uint32 count = read32(data + 8);
+    size_t at    = HEADER_SIZE;
+
+    masks[0] = read32(data + 16);
+    masks[1] = read32(data + 20);
+    masks[2] = read32(data + 24);
+
+    for(Uint32 i = 0; i < count; i++)
+    {
+        if(at + 2 > size)
+            return false;
+
+        size_t length = read16(data + at);
+        at += 2;
+
+        if(at + length + 20 > size)
+            return false;
+
+        string name((const char*)data + at, length);
+        at += length;
+
+        Entry e;
+        e.w          = (int)read16(data + at);
+        e.h          = (int)read16(data + at + 2);
+        e.offset     = read32(data + at + 4);
+        e.packed     = read32(data + at + 8);
+        e.sourceSize = read32(data + at + 12);
+        e.sourceTime = read32(data + at + 16);
+        at += 20;
+
+        if(e.offset > size || e.packed > size - e.offset)
+            return false;
+
+        index[name] = e;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              stamp
+ Description:       The size and modification time of a file, as the index
+                    keeps them for each image's .bmp
+
+ Output:
+    returns         false if the file is not there
+ ******************************************************************************/
+bool Archive::stamp(const char* path, Uint32& bytes, Uint32& mtime)
+{
+    struct stat info;
+
+    if(stat(path, &info) != 0)
+        return false;
+
+    bytes = (Uint32)info.st_size;
+    mtime = (Uint32)info.st_mtime;
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              close
+ Description:       Unmaps the archive. Surfaces already loaded are not
+                    affected, they hold their own pixels.
+ ******************************************************************************/
+void Archive::close()
+{
+    if(data)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap((void*)data, size);
+#endif
+    }
+
+    data = NULL;
+    size = 0;
+    index.clear();
+}
+
+/*******************************************************************************
+ Name:              load
+ Description:       Decodes an image into a new surface, in the format it
+                    was packed in
+
+ Input:
+    name            The .bmp file it was packed from
+
+ Output:
+    returns         The surface, for the caller to free, or NULL if the
+                    archive does not hold the image, it is damaged, or its
+                    .bmp has changed since it was packed
+ ******************************************************************************/
+SDL_Surface* Archive::load(const char* name)
+{
+    map<string, Entry>::iterator it = index.find(name);
+
+    if(it == index.end())
+        return NULL;
+
+    Entry& e = it->second;
+    Uint32 sourceSize, sourceTime;
+
+    if(stamp(name, sourceSize, sourceTime) &&
+       (sourceSize != e.sourceSize || sourceTime != e.sourceTime))
+    {
+        SDL_LockMutex(lock);
+        numStale++;
+        SDL_UnlockMutex(lock);
+        return NULL;
+    }
+
+    SDL_Surface* s = SDL_CreateRGBSurface(SDL_SWSURFACE, e.w, e.h, 32,
+                                          masks[0], masks[1], masks[2], 0);
+
+    if(!s)
+        return NULL;
+
+    const unsigned char* src   = data + e.offset;
+    int                  row   = e.w * 4;
+    int                  bytes = row * e.h;
+    int                  out;
+
+    if(s->pitch == row)
+    {
+        out = Lz4::decompress(src, (int)e.packed, (unsigned char*)s->pixels, bytes);
+    }
+    else
+    {
+        vector<unsigned char> pixels(bytes);
+
+        out = Lz4::decompress(src, (int)e.packed, &pixels[0], bytes);
+
+        for(int y = 0; out == bytes && y < e.h; y++)
+            memcpy((Uint8*)s->pixels + y * s->pitch, &pixels[y * row], row);
+    }
+
+    if(out != bytes)
+    {
+        cout << name << ": damaged in the archive" << endl;
+        SDL_FreeSurface(s);
+        return NULL;
+    }
+
+    SDL_LockMutex(lock);
+    numLoads++;
+    bytesRead += e.packed;
+    SDL_UnlockMutex(lock);
+
+    return s;
+}
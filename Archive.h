@@ -0,0 +1,94 @@
+/*******************************************************************************
+ Filename:                  Archive.h
+ Classname:                 Archive
+
+ Description:               This file declares the Archive class. An Archive
+                            is one file holding every image the game ships,
+                            built by tools/PackAssets.cpp from the loose
+                            .bmp files. Each image is stored as 32 bit pixels
+                            in the usual display format, so it needs no
+                            conversion once loaded, and compressed on its own
+                            with Lz4, so any one can be read without the
+                            others.
+
+                            open() maps the file into memory and reads only
+                            the index; load() decodes an image when it is
+                            first asked for, so starting the game or a level
+                            touches only the pages of the images it draws.
+                            load() may be called from more than one thread
+                            at once, as the Prefetcher does.
+
+                            Each entry keeps the size and modification time
+                            its .bmp had when packed. Where the .bmp is
+                            there and they no longer match, the image was
+                            edited since, and load() leaves it to be read
+                            from the .bmp.
+
+                            The file, little endian throughout:
+                                "APAK", version, number of images,
+                                bits per pixel, red, green and blue masks
+                                per image: name length (16 bits), name,
+                                    width, height (16 bits each),
+                                    offset from the start of the file,
+                                    compressed size,
+                                    the .bmp's size and modification time
+                                the compressed pixels, rows top to bottom
+                                with no padding
+ ******************************************************************************/
+
+#ifndef AngrySomething_Archive_h
+#define AngrySomething_Archive_h
+
+#include <map>
+#include <string>
+#include <cstddef>
+#include <SDL/SDL.h>
+
+using namespace std;
+
+class Archive
+{
+    private:
+        struct Entry
+        {
+            int     w, h;
+            Uint32  offset;
+            Uint32  packed;
+            Uint32  sourceSize;
+            Uint32  sourceTime;
+        };
+
+        map<string, Entry>      index;
+        const unsigned char*    data;       //the mapped file
+        size_t                  size;
+        Uint32                  masks[3];   //red, green, blue
+        SDL_mutex*              lock;       //guards the counts
+        int                     numLoads;
+        size_t                  bytesRead;
+        int                     numStale;
+
+        bool                    mapFile(const char* path);
+        bool                    readIndex();
+
+    public:
+        static const Uint32     VERSION = 2;
+
+        static bool             stamp(const char* path, Uint32& bytes, Uint32& mtime);
+
+        Archive();
+        ~Archive();
+
+        bool                    open(const char* path);
+        void                    close();
+        bool                    isOpen() {return data != NULL;}
+        bool                    contains(const char* name) {return index.count(name) > 0;}
+        SDL_Surface*            load(const char* name);
+
+        int                     getNumImages() {return (int)index.size();}
+        int                     getNumLoads() {return numLoads;}
+        int                     getNumStale() {return numStale;}
+        size_t                  getBytesRead() {return bytesRead;}
+        size_t                  getSize() {return size;}
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ Filename:                  Arena.cpp
+ Classname:                 Arena
+
+ Description:               This file defines the Arena class.
+ ******************************************************************************/
+
+#include <cstdlib>
+#include <new>
+
+#include "Arena.h"
+
+//every block starts on this boundary, enough for any member of an Object
+const size_t ARENA_ALIGN = 16;
+
+/*******************************************************************************
+ Name:              Arena
+ Description:       Constructor. No memory is taken until the first alloc.
+
+ Input:
+    chunk           Size of each chunk; bigger blocks get a chunk of their own
+ ******************************************************************************/
+Arena::Arena(size_t chunk)
+{
+    chunkSize = chunk;
+    current   = 0;
+    used      = 0;
+}
+
+Arena::~Arena()
+{
+    for(int i = 0; i < (int)chunks.size(); i++)
+        free(chunks[i].mem);
+}
+
+/*******************************************************************************
+ Name:              alloc
+ Description:       Hands out the next n bytes, moving on to the next chunk,
+                    or making one, when the current chunk is full
+
+ Output:
+    returns         Memory for n bytes, aligned to ARENA_ALIGN
+ ******************************************************************************/
+void* Arena::alloc(size_t n)
+{
+    n = (n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    while(current < (int)chunks.size() && used + n > chunks[current].size)
+    {
+        current++;
+        used = 0;
+    }
+
+    if(current == (int)chunks.size())
+    {
+        Chunk c;
+        c.size = n > chunkSize ? n : chunkSize;
+        c.mem  = (char*)malloc(c.size);
+
+        if(!c.mem)
+            throw bad_alloc();
+
+        chunks.push_back(c);
+        used = 0;
+    }
+
+    void* p = chunks[current].mem + used;
+    used += n;
+
+    return p;
+}
+
+/*******************************************************************************
+ Name:              owns
+ Description:       Whether p points into memory this Arena handed out
+ ******************************************************************************/
+bool Arena::owns(const void* p) const
+{
+    const char* c = (const char*)p;
+
+    for(int i = 0; i < (int)chunks.size(); i++)
+    {
+        if(c >= chunks[i].mem && c < chunks[i].mem + chunks[i].size)
+            return true;
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ Name:              reset
+ Description:       Takes back everything handed out. The chunks are kept, so
+                    the next level loads into the same memory.
+ ******************************************************************************/
+void Arena::reset()
+{
+    current = 0;
+    used    = 0;
+}
+
+/*******************************************************************************
+ Name:              getReserved
+ Description:       Bytes held in chunks, handed out or not
+ ******************************************************************************/
+size_t Arena::getReserved() const
+{
+    size_t total = 0;
+
+    for(int i = 0; i < (int)chunks.size(); i++)
+        total += chunks[i].size;
+
+    return total;
+}
+
+void* operator new(size_t n, Arena& arena)
+{
+    return arena.alloc(n);
+}
+
+//only called if a constructor throws; the arena takes the memory back on reset
+void operator delete(void* p, Arena& arena)
+{
+}
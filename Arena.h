@@ -0,0 +1,59 @@
+/*******************************************************************************
+ Filename:                  Arena.h
+ Classname:                 Arena
+
+ Description:               This file declares the Arena class. An Arena hands
+                            out memory from a few large chunks by moving a
+                            pointer along them, and takes it all back at once
+                            with reset(). Room builds its level objects in one
+                            with placement new:
+
+                                add(new (arena) Pig(...));
+
+                            so loading a level costs a handful of mallocs and
+                            unloading it none. Objects built in an Arena must
+                            be destroyed by calling their destructor, never by
+                            delete.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Arena_h
+#define AngrySomething_Arena_h
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+class Arena
+{
+    private:
+        struct Chunk
+        {
+            char*   mem;
+            size_t  size;
+        };
+
+        vector<Chunk>   chunks;
+        size_t          chunkSize;
+        int             current;    //chunk being handed out
+        size_t          used;       //bytes handed out of it
+
+    public:
+        Arena(size_t chunk = 64 * 1024);
+        ~Arena();
+
+        void*   alloc(size_t n);
+        bool    owns(const void* p) const;
+        void    reset();
+
+        size_t  getReserved() const;
+
+    private:
+        Arena(const Arena&);
+        Arena&  operator=(const Arena&);
+};
+
+void*   operator new(size_t n, Arena& arena);
+void    operator delete(void* p, Arena& arena);
+
+#endif
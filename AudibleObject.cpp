@@ -3,10 +3,16 @@
 
 AudibleObject::AudibleObject(string file)
 {
-    noise = Mix_LoadWAV( "noise.wav" );
-    if(!noise)
+    noise = NULL;
+    noisy = false;
+
+    if(!isHeadless())
     {
-        exit(-1);
+        noise = Mix_LoadWAV( "noise.wav" );
+        if(!noise)
+        {
+            exit(-1);
+        }
     }
     
     audible = true;
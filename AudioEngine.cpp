@@ -28,16 +28,15 @@ AudioEngine::~AudioEngine()
 
 void AudioEngine::run(Room& room)
 {
-    for(int i = 0; i < room.getNumObjects(); i++)
+    vector<AudibleObject*>& audibles = room.getAudibles();
+
+    for(int i = 0; i < (int)audibles.size(); i++)
     {
-        if(room.getObjectAt(i)->isAudible())
+        AudibleObject* ao = audibles[i];
+        if(ao->wantsToBeNoisy())
         {
-            AudibleObject* ao = dynamic_cast<AudibleObject*>(room.getObjectAt(i));
-            if(ao->wantsToBeNoisy())
-            {
-                Mix_Chunk* noise = ao->getNoise();
-                Mix_PlayChannel(-1, noise, 0);
-            }
+            Mix_Chunk* noise = ao->getNoise();
+            Mix_PlayChannel(-1, noise, 0);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,445 @@
+/*******************************************************************************
+ Filename:                  Blitter.cpp
+ Classname:                 Blitter
+
+ Description:               This file defines the Blitter class.
+ ******************************************************************************/
+
+#include <cstring>
+
+#include "Blitter.h"
+#include "DrawList.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BLITTER_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/*******************************************************************************
+ Name:              keyedScalar, keyedSSE2, keyedAVX2
+ Description:       Copy a row of w pixels, leaving out those equal to key
+                    and keeping only the bits in rgb of the rest. The SIMD
+                    kernels compare a block of pixels with the key at once;
+                    a block of only key is skipped, a block with none is
+                    stored whole, and a mixed one keeps what was under its
+                    key pixels. The last pixels short of a block are done
+                    4 and then 1 at a time. Nothing built for SSE2 alone is
+                    called from the AVX2 kernel: mixing the two encodings
+                    stalls the CPU at every switch.
+ ******************************************************************************/
+static void keyedScalar(const Uint32* s, Uint32* d, int w, Uint32 key, Uint32 rgb)
+{
+    for(int i = 0; i < w; i++)
+    {
+        if(s[i] != key)
+            d[i] = s[i] & rgb;
+    }
+}
+
+#ifdef BLITTER_X86
+
+TARGET_SSE2 static inline void keyed4(const Uint32* s, Uint32* d, __m128i k, __m128i m)
+{
+    __m128i p    = _mm_loadu_si128((const __m128i*)s);
+    __m128i hole = _mm_cmpeq_epi32(p, k);
+    int     mask = _mm_movemask_epi8(hole);
+
+    if(mask == 0xFFFF)
+        return;
+
+    p = _mm_and_si128(p, m);
+
+    if(mask)
+    {
+        __m128i under = _mm_loadu_si128((const __m128i*)d);
+        p = _mm_or_si128(_mm_andnot_si128(hole, p), _mm_and_si128(hole, under));
+    }
+
+    _mm_storeu_si128((__m128i*)d, p);
+}
+
+TARGET_SSE2 static void keyedSSE2(const Uint32* s, Uint32* d, int w, Uint32 key, Uint32 rgb)
+{
+    __m128i k = _mm_set1_epi32((int)key);
+    __m128i m = _mm_set1_epi32((int)rgb);
+    int     i = 0;
+
+    for(; i + 4 <= w; i += 4)
+        keyed4(s + i, d + i, k, m);
+
+    keyedScalar(s + i, d + i, w - i, key, rgb);
+}
+
+TARGET_AVX2 static void keyedAVX2(const Uint32* s, Uint32* d, int w, Uint32 key, Uint32 rgb)
+{
+    __m256i k = _mm256_set1_epi32((int)key);
+    __m256i m = _mm256_set1_epi32((int)rgb);
+    int     i = 0;
+
+    for(; i + 8 <= w; i += 8)
+    {
+        __m256i p    = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i hole = _mm256_cmpeq_epi32(p, k);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(hole);
+
+        if(mask == 0xFFFFFFFFu)
+            continue;
+
+        p = _mm256_and_si256(p, m);
+
+        if(mask)
+        {
+            __m256i under = _mm256_loadu_si256((const __m256i*)(d + i));
+            p = _mm256_blendv_epi8(p, under, hole);
+        }
+
+        _mm256_storeu_si256((__m256i*)(d + i), p);
+    }
+
+    //inlined here, so it stays in AVX encoding
+    if(i + 4 <= w)
+    {
+        keyed4(s + i, d + i, _mm256_castsi256_si128(k), _mm256_castsi256_si128(m));
+        i += 4;
+    }
+
+    keyedScalar(s + i, d + i, w - i, key, rgb);
+}
+
+/*******************************************************************************
+ Name:              cpuHasAVX2
+ Description:       Whether the CPU has AVX2 and the OS saves its registers
+ ******************************************************************************/
+static bool cpuHasAVX2()
+{
+#ifdef _MSC_VER
+    int r[4];
+
+    __cpuid(r, 0);
+    if(r[0] < 7)
+        return false;
+
+    __cpuid(r, 1);
+    if(!(r[2] & (1 << 27)) || !(r[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif
+
+SDL_mutex*          Blitter::slowLock = NULL;
+bool                Blitter::generic  = false;
+SDL_Surface*        Blitter::recorder  = NULL;
+DrawList*           Blitter::recording = NULL;
+int                 Blitter::kernel   = KERNEL_SCALAR;
+Blitter::KeyedRow   Blitter::keyedRow = keyedScalar;
+
+/*******************************************************************************
+ Name:              bestKernel
+ Description:       The widest kernel this CPU runs, picked at start up
+ ******************************************************************************/
+static int bestKernel()
+{
+    for(int k = NUM_KERNELS - 1; k > KERNEL_SCALAR; k--)
+    {
+        if(Blitter::hasKernel(k))
+            return k;
+    }
+
+    return KERNEL_SCALAR;
+}
+
+const bool KERNEL_PICKED = Blitter::setKernel(bestKernel());
+
+/*******************************************************************************
+ Name:              hasKernel
+ Description:       Whether a kernel is built in and this CPU can run it
+ ******************************************************************************/
+bool Blitter::hasKernel(int k)
+{
+    switch(k)
+    {
+        case KERNEL_SCALAR:
+            return true;
+#ifdef BLITTER_X86
+        case KERNEL_SSE2:
+            return SDL_HasSSE2() != 0;
+        case KERNEL_AVX2:
+            return SDL_HasSSE2() && cpuHasAVX2();
+#endif
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+ Name:              setKernel
+ Description:       Chooses the kernel for color keyed rows. For comparing
+                    them; not while anything is drawing.
+
+ Output:
+    returns         false, leaving the kernel as it was, if the CPU cannot
+                    run it
+ ******************************************************************************/
+bool Blitter::setKernel(int k)
+{
+    if(!hasKernel(k))
+        return false;
+
+    switch(k)
+    {
+#ifdef BLITTER_X86
+        case KERNEL_SSE2:   keyedRow = keyedSSE2;   break;
+        case KERNEL_AVX2:   keyedRow = keyedAVX2;   break;
+#endif
+        default:            keyedRow = keyedScalar; break;
+    }
+
+    kernel = k;
+    return true;
+}
+
+const char* Blitter::kernelName(int k)
+{
+    switch(k)
+    {
+        case KERNEL_SCALAR: return "scalar";
+        case KERNEL_SSE2:   return "SSE2";
+        case KERNEL_AVX2:   return "AVX2";
+        default:            return "?";
+    }
+}
+
+/*******************************************************************************
+ Name:              init
+ Description:       Makes the lock blits handed to SDL take, and the surface
+                    to record onto. Call on the main thread before blitting
+                    from more than one.
+ ******************************************************************************/
+void Blitter::init()
+{
+    if(!slowLock)
+        slowLock = SDL_CreateMutex();
+
+    if(!recorder)
+        recorder = SDL_CreateRGBSurface(SDL_SWSURFACE, 1, 1, 32, 0, 0, 0, 0);
+}
+
+void Blitter::shutdown()
+{
+    if(slowLock)
+        SDL_DestroyMutex(slowLock);
+    slowLock = NULL;
+
+    SDL_FreeSurface(recorder);
+    recorder = NULL;
+}
+
+/*******************************************************************************
+ Name:              startRecording
+ Description:       Blits onto the surface returned are added to list until
+                    stopRecording(). Only one thread may record at a time.
+ ******************************************************************************/
+SDL_Surface* Blitter::startRecording(DrawList* list)
+{
+    recording = list;
+    return recorder;
+}
+
+/*******************************************************************************
+ Name:              blit
+ Description:       Draws src onto dst, as SDL_BlitSurface does: srcrect is
+                    cut to src, then the result to dst's clip rectangle, and
+                    dstrect is set to the part drawn
+
+ Input:
+    src             Surface to draw, NULL draws nothing
+    srcrect         Part of src to draw, NULL for all of it
+    dst             Surface to draw onto
+    dstrect         Where to draw, only x and y are read; NULL for 0, 0
+
+ Output:
+    returns         0, or -1 if there is no src or dst
+ ******************************************************************************/
+int Blitter::blit(SDL_Surface* src, SDL_Rect* srcrect,
+                  SDL_Surface* dst, SDL_Rect* dstrect)
+{
+    if(!src || !dst)
+        return -1;
+
+    if(dst == recorder)
+    {
+        if(recording)
+            recording->add(src, srcrect, dstrect);
+        return 0;
+    }
+
+    if(generic || !isDirect(src, dst))
+    {
+        if(slowLock)
+            SDL_mutexP(slowLock);
+
+        int r = SDL_BlitSurface(src, srcrect, dst, dstrect);
+
+        if(slowLock)
+            SDL_mutexV(slowLock);
+
+        return r;
+    }
+
+    SDL_Rect to;
+    to.x = dstrect ? dstrect->x : 0;
+    to.y = dstrect ? dstrect->y : 0;
+
+    //cut to the source, moving the destination along
+    int x, y, w, h;
+
+    if(srcrect)
+    {
+        x = srcrect->x;
+        y = srcrect->y;
+        w = srcrect->w;
+        h = srcrect->h;
+
+        if(x < 0)
+        {
+            w += x;
+            to.x -= x;
+            x = 0;
+        }
+        if(y < 0)
+        {
+            h += y;
+            to.y -= y;
+            y = 0;
+        }
+        if(w > src->w - x)  w = src->w - x;
+        if(h > src->h - y)  h = src->h - y;
+    }
+    else
+    {
+        x = 0;
+        y = 0;
+        w = src->w;
+        h = src->h;
+    }
+
+    //cut to the destination's clip rectangle
+    SDL_Rect& clip = dst->clip_rect;
+    int d;
+
+    d = clip.x - to.x;
+    if(d > 0)
+    {
+        w -= d;
+        x += d;
+        to.x += d;
+    }
+    d = to.x + w - clip.x - clip.w;
+    if(d > 0)
+        w -= d;
+
+    d = clip.y - to.y;
+    if(d > 0)
+    {
+        h -= d;
+        y += d;
+        to.y += d;
+    }
+    d = to.y + h - clip.y - clip.h;
+    if(d > 0)
+        h -= d;
+
+    if(w <= 0 || h <= 0)
+    {
+        if(dstrect)
+        {
+            dstrect->w = 0;
+            dstrect->h = 0;
+        }
+        return 0;
+    }
+
+    SDL_Rect from;
+    from.x = x;
+    from.y = y;
+    from.w = to.w = w;
+    from.h = to.h = h;
+
+    copy(src, from, dst, to);
+
+    if(dstrect)
+        *dstrect = to;
+
+    return 0;
+}
+
+/*******************************************************************************
+ Name:              isDirect
+ Description:       Whether blit can copy the pixels itself: 32 bits, the
+                    same format, no alpha, nothing to lock
+ ******************************************************************************/
+bool Blitter::isDirect(SDL_Surface* src, SDL_Surface* dst)
+{
+    SDL_PixelFormat* s = src->format;
+    SDL_PixelFormat* d = dst->format;
+
+    return s->BytesPerPixel == 4 && d->BytesPerPixel == 4 &&
+           s->Rmask == d->Rmask && s->Gmask == d->Gmask && s->Bmask == d->Bmask &&
+           s->Amask == 0 && d->Amask == 0 && !(src->flags & SDL_SRCALPHA) &&
+           !SDL_MUSTLOCK(src) && !SDL_MUSTLOCK(dst);
+}
+
+/*******************************************************************************
+ Name:              copy
+ Description:       Copies a clipped rectangle of pixels. With a color key,
+                    pixels of the key color are left out and the rest are
+                    written without their unused byte, as SDL's keyed blit
+                    writes them; without one, rows are copied whole.
+ ******************************************************************************/
+void Blitter::copy(SDL_Surface* src, SDL_Rect& from, SDL_Surface* dst,
+                   SDL_Rect& to)
+{
+    Uint8* s = (Uint8*)src->pixels + from.y * src->pitch + from.x * 4;
+    Uint8* d = (Uint8*)dst->pixels + to.y * dst->pitch + to.x * 4;
+    int    w = from.w;
+    int    h = from.h;
+
+    if(!(src->flags & SDL_SRCCOLORKEY))
+    {
+        for(int row = 0; row < h; row++)
+        {
+            memcpy(d, s, w * 4);
+            s += src->pitch;
+            d += dst->pitch;
+        }
+        return;
+    }
+
+    SDL_PixelFormat* f    = src->format;
+    Uint32           rgb  = f->Rmask | f->Gmask | f->Bmask;
+    Uint32           key  = f->colorkey;
+
+    for(int row = 0; row < h; row++)
+    {
+        keyedRow((const Uint32*)s, (Uint32*)d, w, key, rgb);
+
+        s += src->pitch;
+        d += dst->pitch;
+    }
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ Filename:                  Blitter.h
+ Classname:                 Blitter
+
+ Description:               This file declares the Blitter class. Objects draw
+                            with Blitter::blit, which takes the same arguments
+                            and gives the same pixels as SDL_BlitSurface.
+                            Between 32 bit surfaces of one pixel format, the
+                            common case once images are in the display
+                            format, it copies the pixels itself, honoring the
+                            color key, and touches nothing but the
+                            destination's pixels. That lets the GraphicsEngine
+                            draw different parts of the screen on different
+                            threads, each through its own surface. Other
+                            blits go to SDL one at a time, as SDL's blit
+                            changes the source surface.
+
+                            Color keyed rows are copied by the widest kernel
+                            the CPU has, picked when the program starts:
+                            AVX2 (8 pixels at a time), SSE2 (4) or plain C.
+                            All three give the same pixels.
+
+                            Blits onto the surface startRecording() returns
+                            are not drawn but added to a DrawList, to be
+                            replayed later, maybe on another thread.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Blitter_h
+#define AngrySomething_Blitter_h
+
+#include <SDL/SDL.h>
+
+class DrawList;
+
+enum {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2, NUM_KERNELS};
+
+class Blitter
+{
+    private:
+        //copies w pixels but those equal to key, keeping the bits in rgb
+        typedef void (*KeyedRow)(const Uint32* s, Uint32* d, int w,
+                                 Uint32 key, Uint32 rgb);
+
+        static SDL_mutex*   slowLock;   //around blits handed to SDL
+        static bool         generic;
+        static SDL_Surface* recorder;   //blits onto it are written down
+        static DrawList*    recording;
+        static int          kernel;
+        static KeyedRow     keyedRow;
+
+        static bool isDirect(SDL_Surface* src, SDL_Surface* dst);
+        static void copy(SDL_Surface* src, SDL_Rect& from, SDL_Surface* dst,
+                         SDL_Rect& to);
+
+    public:
+        static void init();
+        static void shutdown();
+
+        static int  blit(SDL_Surface* src, SDL_Rect* srcrect,
+                         SDL_Surface* dst, SDL_Rect* dstrect);
+
+        static SDL_Surface* startRecording(DrawList* list);
+        static void         stopRecording() {recording = NULL;}
+
+        static void setGeneric(bool on) {generic = on;}
+        static bool getGeneric() {return generic;}
+
+        static bool         hasKernel(int k);
+        static bool         setKernel(int k);
+        static int          getKernel() {return kernel;}
+        static const char*  kernelName(int k);
+};
+
+#endif
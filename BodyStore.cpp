@@ -0,0 +1,310 @@
+/*******************************************************************************
+ Filename:                  BodyStore.cpp
+ Classname:                 BodyStore
+
+ Description:               This file defines the BodyStore class. The
+                            BodyStore keeps the motion state of every
+                            PhysicalObject (velocity, acceleration, mass and
+                            flags) in parallel arrays, one slot per body, so
+                            the whole set can be integrated in one pass with
+                            SIMD instructions.
+
+                            integrate() uses AVX (4 bodies per instruction)
+                            when the compiler targets it, SSE2 (2 bodies) on
+                            any other x86, and plain C++ everywhere else. All
+                            three give bit-identical results.
+ ******************************************************************************/
+
+#include <cmath>
+
+#include "BodyStore.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+extern const double GRAV        = .3;
+extern const double TERM_VEL    = 20;
+
+const double DEAD_X = .3;       //slower than this horizontally stops
+const double DEAD_Y = 1.5;      //slower than this vertically stops when grounded
+
+/*******************************************************************************
+ Name:              BodyStore
+ Description:       Default constructor
+ ******************************************************************************/
+BodyStore::BodyStore()
+{
+    nextSerial = 0;
+}
+
+/*******************************************************************************
+ Name:              add
+ Description:       Claims a slot for a new body, reusing a freed one if any
+
+ Input:
+    vx, vy          Starting velocity
+    m               Mass
+
+ Output:
+    returns         The slot index
+ ******************************************************************************/
+int BodyStore::add(double vx, double vy, int m)
+{
+    int i;
+
+    if(!freeSlots.empty())
+    {
+        i = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        i = size();
+        velX.push_back(0);
+        velY.push_back(0);
+        accX.push_back(0);
+        accY.push_back(0);
+        mass.push_back(0);
+        flags.push_back(0);
+        stepX.push_back(0);
+        stepY.push_back(0);
+        serial.push_back(0);
+    }
+
+    velX[i]  = vx;
+    velY[i]  = vy;
+    accX[i]  = 0;
+    accY[i]  = GRAV;
+    mass[i]  = m;
+    flags[i] = BODY_LIVE;
+    stepX[i] = stepY[i] = 0;
+
+    //slots are reused, serials never are
+    serial[i] = nextSerial++;
+
+    return i;
+}
+
+/*******************************************************************************
+ Name:              remove
+ Description:       Frees a slot. Freed slots are never integrated.
+ ******************************************************************************/
+void BodyStore::remove(int i)
+{
+    flags[i] = 0;
+    stepX[i] = stepY[i] = 0;
+    freeSlots.push_back(i);
+}
+
+void BodyStore::setFlag(int i, int f, bool on)
+{
+    if(on)  flags[i] |= f;
+    else    flags[i] &= ~f;
+}
+
+/*******************************************************************************
+ Name:              integrate
+ Description:       Advances one body, or every BODY_ACTIVE body, by one tick:
+                    applies acceleration, clamps to terminal velocity, snaps
+                    slow velocities to zero, resets acceleration to gravity
+                    and records the whole-pixel step the body should move.
+                    Inactive bodies are left untouched with a step of zero.
+ ******************************************************************************/
+void BodyStore::integrate(int i)
+{
+    integrateScalar(i, i + 1);
+}
+
+void BodyStore::integrateScalar(int first, int last)
+{
+    for(int i = first; i < last; i++)
+    {
+        if(!(flags[i] & BODY_ACTIVE))
+        {
+            stepX[i] = stepY[i] = 0;
+            continue;
+        }
+
+        double vx = velX[i] + accX[i];
+        double vy = velY[i] + accY[i];
+
+        //terminal velocities
+        if(vy > TERM_VEL)  vy = TERM_VEL;
+        if(vy < -TERM_VEL) vy = -TERM_VEL;
+        if(vx > TERM_VEL)  vx = TERM_VEL;
+        if(vx < -TERM_VEL) vx = -TERM_VEL;
+
+        if(fabs(vx) < DEAD_X) vx = 0;
+        if(fabs(vy) < DEAD_Y && (flags[i] & BODY_GROUNDED)) vy = 0;
+
+        velX[i] = vx;
+        velY[i] = vy;
+        accX[i] = 0;
+        accY[i] = GRAV;
+
+        stepX[i] = (int)round(vx);
+        stepY[i] = (int)round(vy);
+
+        flags[i] &= ~BODY_GROUNDED;
+    }
+}
+
+#if defined(__AVX__)
+
+/*******************************************************************************
+ Name:              roundAway
+ Description:       round() for four doubles, halves rounded away from zero
+ ******************************************************************************/
+static inline __m256d roundAway(__m256d v)
+{
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d half = _mm256_set1_pd(.5);
+    const __m256d one  = _mm256_set1_pd(1);
+
+    __m256d t    = _mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256d frac = _mm256_andnot_pd(sign, _mm256_sub_pd(v, t));
+    __m256d away = _mm256_or_pd(_mm256_and_pd(v, sign), one);
+
+    return _mm256_add_pd(t, _mm256_and_pd(_mm256_cmp_pd(frac, half, _CMP_GE_OQ), away));
+}
+
+void BodyStore::integrate()
+{
+    const __m256d grav  = _mm256_set1_pd(GRAV);
+    const __m256d term  = _mm256_set1_pd(TERM_VEL);
+    const __m256d nterm = _mm256_set1_pd(-TERM_VEL);
+    const __m256d deadX = _mm256_set1_pd(DEAD_X);
+    const __m256d deadY = _mm256_set1_pd(DEAD_Y);
+    const __m256d sign  = _mm256_set1_pd(-0.0);
+    const __m256d zero  = _mm256_setzero_pd();
+    const __m128i fAct  = _mm_set1_epi32(BODY_ACTIVE);
+    const __m128i fGnd  = _mm_set1_epi32(BODY_GROUNDED);
+
+    int n = size();
+    int i = 0;
+
+    for(; i + 4 <= n; i += 4)
+    {
+        __m128i f    = _mm_loadu_si128((__m128i*)&flags[i]);
+        __m128i actI = _mm_cmpeq_epi32(_mm_and_si128(f, fAct), fAct);
+        __m128i gndI = _mm_cmpeq_epi32(_mm_and_si128(f, fGnd), fGnd);
+        __m256d act  = _mm256_cmp_pd(_mm256_cvtepi32_pd(_mm_and_si128(actI, fAct)), zero, _CMP_NEQ_OQ);
+        __m256d gnd  = _mm256_cmp_pd(_mm256_cvtepi32_pd(_mm_and_si128(gndI, fGnd)), zero, _CMP_NEQ_OQ);
+
+        __m256d vx = _mm256_loadu_pd(&velX[i]);
+        __m256d vy = _mm256_loadu_pd(&velY[i]);
+        __m256d ax = _mm256_loadu_pd(&accX[i]);
+        __m256d ay = _mm256_loadu_pd(&accY[i]);
+
+        __m256d nx = _mm256_add_pd(vx, ax);
+        __m256d ny = _mm256_add_pd(vy, ay);
+
+        //terminal velocities
+        nx = _mm256_min_pd(_mm256_max_pd(nx, nterm), term);
+        ny = _mm256_min_pd(_mm256_max_pd(ny, nterm), term);
+
+        //dead zones
+        nx = _mm256_andnot_pd(_mm256_cmp_pd(_mm256_andnot_pd(sign, nx), deadX, _CMP_LT_OQ), nx);
+        ny = _mm256_andnot_pd(_mm256_and_pd(_mm256_cmp_pd(_mm256_andnot_pd(sign, ny), deadY, _CMP_LT_OQ), gnd), ny);
+
+        //only active lanes take the new state
+        _mm256_storeu_pd(&velX[i], _mm256_blendv_pd(vx, nx, act));
+        _mm256_storeu_pd(&velY[i], _mm256_blendv_pd(vy, ny, act));
+        _mm256_storeu_pd(&accX[i], _mm256_blendv_pd(ax, zero, act));
+        _mm256_storeu_pd(&accY[i], _mm256_blendv_pd(ay, grav, act));
+
+        _mm_storeu_si128((__m128i*)&stepX[i], _mm256_cvttpd_epi32(_mm256_and_pd(roundAway(nx), act)));
+        _mm_storeu_si128((__m128i*)&stepY[i], _mm256_cvttpd_epi32(_mm256_and_pd(roundAway(ny), act)));
+
+        _mm_storeu_si128((__m128i*)&flags[i], _mm_andnot_si128(_mm_and_si128(actI, fGnd), f));
+    }
+
+    integrateScalar(i, n);
+}
+
+#elif defined(__SSE2__)
+
+/*******************************************************************************
+ Name:              roundAway
+ Description:       round() for two doubles, halves rounded away from zero.
+                    Velocities are clamped to TERM_VEL first, so the int32
+                    truncation cannot overflow.
+ ******************************************************************************/
+static inline __m128d roundAway(__m128d v)
+{
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d half = _mm_set1_pd(.5);
+    const __m128d one  = _mm_set1_pd(1);
+
+    __m128d t    = _mm_cvtepi32_pd(_mm_cvttpd_epi32(v));
+    __m128d frac = _mm_andnot_pd(sign, _mm_sub_pd(v, t));
+    __m128d away = _mm_or_pd(_mm_and_pd(v, sign), one);
+
+    return _mm_add_pd(t, _mm_and_pd(_mm_cmpge_pd(frac, half), away));
+}
+
+void BodyStore::integrate()
+{
+    const __m128d grav  = _mm_set1_pd(GRAV);
+    const __m128d term  = _mm_set1_pd(TERM_VEL);
+    const __m128d nterm = _mm_set1_pd(-TERM_VEL);
+    const __m128d deadX = _mm_set1_pd(DEAD_X);
+    const __m128d deadY = _mm_set1_pd(DEAD_Y);
+    const __m128d sign  = _mm_set1_pd(-0.0);
+    const __m128d zero  = _mm_setzero_pd();
+    const __m128i fAct  = _mm_set1_epi32(BODY_ACTIVE);
+    const __m128i fGnd  = _mm_set1_epi32(BODY_GROUNDED);
+
+    int n = size();
+    int i = 0;
+
+    for(; i + 2 <= n; i += 2)
+    {
+        __m128i f    = _mm_loadl_epi64((__m128i*)&flags[i]);
+        __m128i actI = _mm_cmpeq_epi32(_mm_and_si128(f, fAct), fAct);
+        __m128i gndI = _mm_cmpeq_epi32(_mm_and_si128(f, fGnd), fGnd);
+        __m128d act  = _mm_cmpneq_pd(_mm_cvtepi32_pd(_mm_and_si128(actI, fAct)), zero);
+        __m128d gnd  = _mm_cmpneq_pd(_mm_cvtepi32_pd(_mm_and_si128(gndI, fGnd)), zero);
+
+        __m128d vx = _mm_loadu_pd(&velX[i]);
+        __m128d vy = _mm_loadu_pd(&velY[i]);
+        __m128d ax = _mm_loadu_pd(&accX[i]);
+        __m128d ay = _mm_loadu_pd(&accY[i]);
+
+        __m128d nx = _mm_add_pd(vx, ax);
+        __m128d ny = _mm_add_pd(vy, ay);
+
+        //terminal velocities
+        nx = _mm_min_pd(_mm_max_pd(nx, nterm), term);
+        ny = _mm_min_pd(_mm_max_pd(ny, nterm), term);
+
+        //dead zones
+        nx = _mm_andnot_pd(_mm_cmplt_pd(_mm_andnot_pd(sign, nx), deadX), nx);
+        ny = _mm_andnot_pd(_mm_and_pd(_mm_cmplt_pd(_mm_andnot_pd(sign, ny), deadY), gnd), ny);
+
+        //only active lanes take the new state
+        _mm_storeu_pd(&velX[i], _mm_or_pd(_mm_and_pd(act, nx), _mm_andnot_pd(act, vx)));
+        _mm_storeu_pd(&velY[i], _mm_or_pd(_mm_and_pd(act, ny), _mm_andnot_pd(act, vy)));
+        _mm_storeu_pd(&accX[i], _mm_andnot_pd(act, ax));
+        _mm_storeu_pd(&accY[i], _mm_or_pd(_mm_and_pd(act, grav), _mm_andnot_pd(act, ay)));
+
+        _mm_storel_epi64((__m128i*)&stepX[i], _mm_cvttpd_epi32(_mm_and_pd(roundAway(nx), act)));
+        _mm_storel_epi64((__m128i*)&stepY[i], _mm_cvttpd_epi32(_mm_and_pd(roundAway(ny), act)));
+
+        _mm_storel_epi64((__m128i*)&flags[i], _mm_andnot_si128(_mm_and_si128(actI, fGnd), f));
+    }
+
+    integrateScalar(i, n);
+}
+
+#else
+
+void BodyStore::integrate()
+{
+    integrateScalar(0, size());
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ Filename:                  BodyStore.h
+ Classname:                 BodyStore
+
+ Description:               This file declares the BodyStore class. The
+                            BodyStore keeps the motion state of every
+                            PhysicalObject (velocity, acceleration, mass and
+                            flags) in parallel arrays, one slot per body, so
+                            the whole set can be integrated in one pass with
+                            SIMD instructions.
+ ******************************************************************************/
+
+#ifndef AngrySomething_BodyStore_h
+#define AngrySomething_BodyStore_h
+
+#include <vector>
+
+#include "Geometry.h"
+
+using namespace std;
+
+extern const double GRAV;
+extern const double TERM_VEL;
+
+/*******************************************************************************
+ Enum bodyFlag
+ ******************************************************************************/
+enum bodyFlag
+{
+    BODY_LIVE       = 1,    //slot belongs to a body
+    BODY_ACTIVE     = 2,    //body is integrated this tick
+    BODY_GROUNDED   = 4     //body touched something below it last tick
+};
+
+class BodyStore
+{
+    private:
+        vector<double>  velX;
+        vector<double>  velY;
+        vector<double>  accX;
+        vector<double>  accY;
+        vector<int>     mass;
+        vector<int>     flags;
+        vector<int>     stepX;
+        vector<int>     stepY;
+        vector<int>     serial;
+        vector<int>     freeSlots;
+        int             nextSerial;
+
+        void    integrateScalar(int first, int last);
+
+    public:
+        BodyStore();
+
+        int     add(double vx, double vy, int m);
+        void    remove(int i);
+        int     size() {return (int)flags.size();}
+
+        Vect    getVel(int i) {return Vect(velX[i], velY[i]);}
+        Vect    getAcc(int i) {return Vect(accX[i], accY[i]);}
+        int     getMass(int i) {return mass[i];}
+        int     getStepX(int i) {return stepX[i];}
+        int     getStepY(int i) {return stepY[i];}
+        int     getSerial(int i) {return serial[i];}
+        bool    hasFlag(int i, int f) {return (flags[i] & f) != 0;}
+
+        void    setVel(int i, Vect v) {velX[i] = v.x; velY[i] = v.y;}
+        void    setAcc(int i, Vect a) {accX[i] = a.x; accY[i] = a.y;}
+        void    addAcc(int i, double x, double y) {accX[i] += x; accY[i] += y;}
+        void    setFlag(int i, int f, bool on);
+
+        void    integrate();
+        void    integrate(int i);
+};
+
+#endif
@@ -0,0 +1,162 @@
+/*******************************************************************************
+ Filename:                  Broadphase.cpp
+ Classname:                 Broadphase
+
+ Description:               This file defines the Broadphase class. The
+                            Broadphase class buckets PhysicalObjects into a
+                            uniform grid of cells by their SDL_Rect bounds so
+                            that only objects sharing a cell are handed to the
+                            PhysicsEngine as candidate collision pairs.
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include "Broadphase.h"
+#include "Geometry.h"
+
+/*******************************************************************************
+ Name:              pairLess
+ Description:       Orders pairs the same way the old (i, j) double loop
+                    visited them, so resolution order does not change
+ ******************************************************************************/
+static bool pairLess(const BodyPair& p, const BodyPair& q)
+{
+    if(p.a != q.a) return p.a < q.a;
+    return p.b < q.b;
+}
+
+/*******************************************************************************
+ Name:              Broadphase
+ Description:       Constructor
+
+ Input:
+    w, h            Size of the playing field in pixels
+    size            Width and height of one grid cell in pixels
+ ******************************************************************************/
+Broadphase::Broadphase(int w, int h, int size)
+{
+    cellSize = size;
+    margin   = 4;
+    numPairs = 0;
+
+    resize(w, h);
+}
+
+/*******************************************************************************
+ Name:              resize
+ Description:       Covers a field of another size. The grid is empty until
+                    the next rebuild.
+ ******************************************************************************/
+void Broadphase::resize(int w, int h)
+{
+    cols = w / cellSize + 1;
+    rows = h / cellSize + 1;
+
+    cells.clear();
+    cells.resize(cols * rows);
+}
+
+/*******************************************************************************
+ Name:              cellX, cellY
+ Description:       Map a pixel coordinate to a grid column/row. Anything off
+                    the field is clamped into the border cells.
+ ******************************************************************************/
+int Broadphase::cellX(int x)
+{
+    if(x < 0) return 0;
+    x /= cellSize;
+    if(x >= cols) return cols - 1;
+    return x;
+}
+
+int Broadphase::cellY(int y)
+{
+    if(y < 0) return 0;
+    y /= cellSize;
+    if(y >= rows) return rows - 1;
+    return y;
+}
+
+/*******************************************************************************
+ Name:              rebuild
+ Description:       Clears the grid and inserts every body into each cell its
+                    bounds touch. Called once per tick, after bodies moved.
+
+ Input:
+    bodies          The PhysicalObjects to bucket, in room order
+ ******************************************************************************/
+void Broadphase::rebuild(vector<PhysicalObject*>& bodies)
+{
+    for(int i = 0; i < (int)cells.size(); i++)
+        cells[i].clear();
+
+    bounds.resize(bodies.size());
+
+    for(int i = 0; i < (int)bodies.size(); i++)
+    {
+        SDL_Rect r = bodies[i]->getPos();
+
+        //pad the bounds, resolving one pair nudges bodies a pixel or so
+        //before the later pairs are tested
+        r.x -= margin;
+        r.y -= margin;
+        r.w += 2 * margin;
+        r.h += 2 * margin;
+        bounds[i] = r;
+
+        //edges are inclusive to match doIntersect
+        int x1 = cellX(r.x), x2 = cellX(r.x + r.w);
+        int y1 = cellY(r.y), y2 = cellY(r.y + r.h);
+
+        for(int y = y1; y <= y2; y++)
+            for(int x = x1; x <= x2; x++)
+                cells[y * cols + x].push_back(i);
+    }
+}
+
+/*******************************************************************************
+ Name:              findPairs
+ Description:       Produces every pair of bodies whose padded bounds overlap. A pair
+                    that shares several cells is only reported from the cell
+                    holding the top-left corner of the overlap, so no pair is
+                    reported twice.
+
+ Output:
+    pairs           Overlapping pairs, sorted by (a, b)
+ ******************************************************************************/
+void Broadphase::findPairs(vector<BodyPair>& pairs)
+{
+    pairs.clear();
+
+    for(int c = 0; c < (int)cells.size(); c++)
+    {
+        vector<int>& cell = cells[c];
+
+        for(int i = 0; i < (int)cell.size(); i++)
+        {
+            for(int j = i + 1; j < (int)cell.size(); j++)
+            {
+                SDL_Rect& a = bounds[cell[i]];
+                SDL_Rect& b = bounds[cell[j]];
+
+                if(!doIntersect(a, b))
+                    continue;
+
+                int ox = cellX(max((int)a.x, (int)b.x));
+                int oy = cellY(max((int)a.y, (int)b.y));
+
+                if(oy * cols + ox != c)
+                    continue;
+
+                BodyPair p;
+                p.a = cell[i];
+                p.b = cell[j];
+                pairs.push_back(p);
+            }
+        }
+    }
+
+    sort(pairs.begin(), pairs.end(), pairLess);
+
+    numPairs = (int)pairs.size();
+}
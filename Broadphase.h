@@ -0,0 +1,51 @@
+/*******************************************************************************
+ Filename:                  Broadphase.h
+ Classname:                 Broadphase
+
+ Description:               This file declares the Broadphase class. The
+                            Broadphase class buckets PhysicalObjects into a
+                            uniform grid of cells by their SDL_Rect bounds so
+                            that only objects sharing a cell are handed to the
+                            PhysicsEngine as candidate collision pairs.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Broadphase_h
+#define AngrySomething_Broadphase_h
+
+#include <vector>
+#include <SDL/SDL.h>
+
+#include "PhysicalObject.h"
+
+using namespace std;
+
+struct BodyPair
+{
+    int             a, b;   //indices into the body list, a < b
+};
+
+class Broadphase
+{
+    private:
+        int                     cellSize;
+        int                     cols;
+        int                     rows;
+        int                     margin;
+        vector< vector<int> >   cells;
+        vector<SDL_Rect>        bounds;
+        int                     numPairs;
+
+        int     cellX(int x);
+        int     cellY(int y);
+
+    public:
+        Broadphase(int w, int h, int size = 64);
+
+        void    resize(int w, int h);
+        void    rebuild(vector<PhysicalObject*>& bodies);
+        void    findPairs(vector<BodyPair>& pairs);
+
+        int     getNumPairs() {return numPairs;}
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ Filename:                  Camera.cpp
+ Classname:                 Camera
+
+ Description:               This file defines the Camera class.
+ ******************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include "Camera.h"
+#include "World.h"
+#include "Object.h"
+
+using namespace std;
+
+const double FOLLOW = .15;      //share of the way to its aim moved each tick
+
+/*******************************************************************************
+ Name:              Camera
+ Description:       Constructor. The view is the size of the screen until
+                    the GraphicsEngine says otherwise.
+ ******************************************************************************/
+Camera::Camera()
+{
+    viewW = 1280;
+    viewH = 720;
+
+    reset();
+}
+
+/*******************************************************************************
+ Name:              reset
+ Description:       Back to the origin, following nothing, with no home
+ ******************************************************************************/
+void Camera::reset()
+{
+    x      = 0;
+    y      = 0;
+    lastX  = 0;
+    lastY  = 0;
+    target = Handle();
+
+    home.x = home.y = 0;
+    home.w = home.h = 0;
+
+    shown.x = 0;
+    shown.y = 0;
+    shown.w = viewW;
+    shown.h = viewH;
+}
+
+/*******************************************************************************
+ Name:              aim
+ Description:       Where the view should be: centered on what it follows,
+                    or on its home, inside the field
+
+ Output:
+    ax, ay          Top left of the view
+    returns         false if there is nothing to aim at
+ ******************************************************************************/
+bool Camera::aim(World& w, double& ax, double& ay)
+{
+    Object*  obj = w.lookup(target);
+    SDL_Rect r;
+
+    if(obj)
+        r = obj->getPos();
+    else if(home.w > 0)
+        r = home;
+    else
+        return false;
+
+    ax = r.x + r.w / 2 - viewW / 2;
+    ay = r.y + r.h / 2 - viewH / 2;
+
+    ax = max(0.0, min(ax, (double)(w.fieldW - viewW)));
+    ay = max(0.0, min(ay, (double)(w.fieldH - viewH)));
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              step
+ Description:       Moves part of the way to the aim. Called once per tick.
+ ******************************************************************************/
+void Camera::step(World& w)
+{
+    double ax, ay;
+
+    lastX = x;
+    lastY = y;
+
+    if(!aim(w, ax, ay))
+        return;
+
+    x += (ax - x) * FOLLOW;
+    y += (ay - y) * FOLLOW;
+
+    //close enough, stop rather than creep a pixel at a time
+    if(fabs(ax - x) < .5)   x = ax;
+    if(fabs(ay - y) < .5)   y = ay;
+}
+
+/*******************************************************************************
+ Name:              settle
+ Description:       Jumps straight to the aim, for a level just loaded
+ ******************************************************************************/
+void Camera::settle(World& w)
+{
+    double ax, ay;
+
+    if(!aim(w, ax, ay))
+        ax = ay = 0;
+
+    x = lastX = ax;
+    y = lastY = ay;
+}
+
+/*******************************************************************************
+ Name:              show
+ Description:       Fixes the view for the frame about to be drawn, between
+                    the last two ticks
+
+ Input:
+    alpha           How far the simulation is into the next tick, 0 to 1
+
+ Output:
+    returns         The view, in the field
+ ******************************************************************************/
+SDL_Rect Camera::show(double alpha)
+{
+    shown.x = (Sint16)floor(lastX + (x - lastX) * alpha + .5);
+    shown.y = (Sint16)floor(lastY + (y - lastY) * alpha + .5);
+    shown.w = viewW;
+    shown.h = viewH;
+
+    return shown;
+}
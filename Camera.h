@@ -0,0 +1,57 @@
+/*******************************************************************************
+ Filename:                  Camera.h
+ Classname:                 Camera
+
+ Description:               This file declares the Camera class. The Camera
+                            is the part of a World's field that is on the
+                            screen. Each tick it glides toward the object it
+                            follows, the bird in flight, or back to its home
+                            over the Sling once that is gone, never showing
+                            past the edges of the field. On a field no bigger
+                            than the screen it stays at the origin.
+
+                            Like a body, it keeps where it was last tick, so
+                            the GraphicsEngine can draw it between ticks.
+                            show() fixes the view for the frame being
+                            recorded; objects drawn on the screen rather than
+                            in the world, like the score, read it back with
+                            getShown().
+ ******************************************************************************/
+
+#ifndef AngrySomething_Camera_h
+#define AngrySomething_Camera_h
+
+#include <SDL/SDL.h>
+
+#include "Handle.h"
+
+struct World;
+
+class Camera
+{
+    private:
+        double      x, y;           //top left, in the field
+        double      lastX, lastY;   //the tick before
+        int         viewW, viewH;
+        Handle      target;
+        SDL_Rect    home;           //shown with nothing to follow
+        SDL_Rect    shown;          //the view of the frame being drawn
+
+        bool        aim(World& w, double& ax, double& ay);
+
+    public:
+        Camera();
+
+        void        reset();
+        void        step(World& w);
+        void        settle(World& w);
+        SDL_Rect    show(double alpha);
+
+        void        follow(Handle h) {target = h;}
+        Handle      getTarget() {return target;}
+        void        setHome(SDL_Rect r) {home = r;}
+        void        setViewSize(int w, int h) {viewW = w; viewH = h;}
+        SDL_Rect    getShown() {return shown;}
+};
+
+#endif
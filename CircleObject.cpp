@@ -9,13 +9,15 @@ CircleObject::CircleObject(int vx, int vy) : PhysicalObject(vx, vy)
 
 Circle CircleObject::getCircle()
 {
+    //pos may have been corrected since run()
+    circ.cent.x = pos.x + circ.rad;
+    circ.cent.y = pos.y + circ.rad;
+
     return circ;
 }
 
 void CircleObject::run()
 {
-    move();
-    
     circ.cent.x = pos.x + circ.rad;
     circ.cent.y = pos.y + circ.rad;
 }
@@ -25,6 +27,7 @@ void CircleObject::run()
  ******************************************************************************/
 void CircleObject::applyForce(int m, Vect v)
 {
-    acc.x += ((m * (v.x)) / mass) * .8;
-    acc.y += ((m * (v.y)) / mass) * .8;
+    int mass = getMass();
+
+    addAcc(((m * (v.x)) / mass) * .8, ((m * (v.y)) / mass) * .8);
 }
\ No newline at end of file
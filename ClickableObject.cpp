@@ -12,6 +12,7 @@ ClickableObject::ClickableObject(const char* file, int x, int y, int w, int h, i
     activePhys = false;
     activeMech = false;
     activeCont = true;
+    fixed = true;
 }
 
 ClickableObject::~ClickableObject()
@@ -72,10 +73,9 @@ int ClickableObject::check()
  ******************************************************************************/
 void ClickableObject::draw(SDL_Surface* s)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect loc = pos;
 
-    SDL_BlitSurface(image, NULL, s, &loc);
+    Blitter::blit(image, &frame, s, &loc);
 }
 
 void ClickableObject::pause()
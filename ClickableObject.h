@@ -22,7 +22,9 @@ class ClickableObject : public DrawableObject, public ControllableObject, public
         ~ClickableObject();
 
         void        draw(SDL_Surface*);
+        SDL_Rect    getBounds() {return imageBounds();}
         int         check();
+        int         getValue() {return value;}
         void        handle(SDL_Event);
         void        pause();
         void        unpause();
@@ -0,0 +1,179 @@
+/*******************************************************************************
+ Filename:                  Compositor.cpp
+ Classname:                 Compositor
+
+ Description:               This file defines the Compositor class.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Compositor.h"
+#include "Blitter.h"
+#include "Geometry.h"
+
+//8 x 5 tiles on a 1280x720 screen
+const int TILE_W = 160;
+const int TILE_H = 144;
+
+/*******************************************************************************
+ Name:              Compositor
+ Description:       Constructor
+ ******************************************************************************/
+Compositor::Compositor()
+{
+    tileW      = TILE_W;
+    tileH      = TILE_H;
+    list       = NULL;
+}
+
+/*******************************************************************************
+ Name:              ~Compositor
+ Description:       Destructor. The views' pixels are the screen's, freeing
+                    a view leaves them be.
+ ******************************************************************************/
+Compositor::~Compositor()
+{
+    for(int i = 0; i < (int)views.size(); i++)
+        SDL_FreeSurface(views[i]);
+}
+
+/*******************************************************************************
+ Name:              setTileSize
+ Description:       Sets the size of the tiles the screen is split into. A
+                    tile the size of the screen draws the frame in one piece.
+ ******************************************************************************/
+void Compositor::setTileSize(int w, int h)
+{
+    if(w > 0 && h > 0)
+    {
+        tileW = w;
+        tileH = h;
+    }
+}
+
+/*******************************************************************************
+ Name:              draw
+ Description:       Draws a frame into parts of the screen, on the pool's
+                    threads
+
+ Input:
+    screen          Surface to draw onto
+    frame           The background and objects, in layer order
+    regions         Parts of the screen to draw, not overlapping
+    pool            Threads to draw on
+ ******************************************************************************/
+void Compositor::draw(SDL_Surface* screen, DrawList& frame, vector<SDL_Rect>& regions,
+                      ThreadPool& pool)
+{
+    list = &frame;
+
+    pieces.clear();
+    binned.clear();
+
+    for(int i = 0; i < (int)regions.size(); i++)
+        split(regions[i]);
+
+    if(pieces.empty())
+        return;
+
+    if(SDL_MUSTLOCK(screen))
+        SDL_LockSurface(screen);
+
+    makeViews(screen);
+    pool.run(this, (int)pieces.size());
+
+    if(SDL_MUSTLOCK(screen))
+        SDL_UnlockSurface(screen);
+}
+
+/*******************************************************************************
+ Name:              split
+ Description:       Cuts a region along the tiles into pieces, and lists the
+                    objects touching each piece
+ ******************************************************************************/
+void Compositor::split(SDL_Rect r)
+{
+    vector<DrawItem>& items = list->items;
+
+    int right  = r.x + r.w;
+    int bottom = r.y + r.h;
+
+    for(int ty = r.y / tileH * tileH; ty < bottom; ty += tileH)
+    {
+        for(int tx = r.x / tileW * tileW; tx < right; tx += tileW)
+        {
+            Piece p;
+            p.rect.x = max(tx, (int)r.x);
+            p.rect.y = max(ty, (int)r.y);
+            p.rect.w = min(tx + tileW, right) - p.rect.x;
+            p.rect.h = min(ty + tileH, bottom) - p.rect.y;
+            p.first  = (int)binned.size();
+
+            for(int i = 0; i < (int)items.size(); i++)
+            {
+                if(doIntersect(items[i].bounds, p.rect))
+                    binned.push_back(i);
+            }
+
+            p.count = (int)binned.size() - p.first;
+            pieces.push_back(p);
+        }
+    }
+}
+
+/*******************************************************************************
+ Name:              makeViews
+ Description:       Gives every piece a surface over the screen's pixels, so
+                    each can be clipped on its own
+ ******************************************************************************/
+void Compositor::makeViews(SDL_Surface* screen)
+{
+    SDL_PixelFormat* f = screen->format;
+
+    //a new screen, start over
+    if(!views.empty() && (views[0]->w != screen->w || views[0]->h != screen->h ||
+                          views[0]->pitch != screen->pitch ||
+                          views[0]->format->BitsPerPixel != f->BitsPerPixel))
+    {
+        for(int i = 0; i < (int)views.size(); i++)
+            SDL_FreeSurface(views[i]);
+        views.clear();
+    }
+
+    while(views.size() < pieces.size())
+    {
+        SDL_Surface* v = SDL_CreateRGBSurfaceFrom(screen->pixels, screen->w, screen->h,
+                                                  f->BitsPerPixel, screen->pitch,
+                                                  f->Rmask, f->Gmask, f->Bmask, f->Amask);
+        if(!v)
+            exit(-1);
+
+        views.push_back(v);
+    }
+
+    for(int i = 0; i < (int)pieces.size(); i++)
+        views[i]->pixels = screen->pixels;
+}
+
+/*******************************************************************************
+ Name:              runTask
+ Description:       Draws one piece: the background under it, then its
+                    items, clipped to it
+ ******************************************************************************/
+void Compositor::runTask(int i)
+{
+    Piece&       p    = pieces[i];
+    SDL_Surface* view = views[i];
+    SDL_Rect     src  = p.rect;
+    SDL_Rect     dst  = p.rect;
+
+    src.x += list->bgX;
+    src.y += list->bgY;
+
+    SDL_SetClipRect(view, &p.rect);
+    Blitter::blit(list->background, &src, view, &dst);
+
+    for(int k = p.first; k < p.first + p.count; k++)
+        list->replay(list->items[binned[k]], view);
+}
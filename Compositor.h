@@ -0,0 +1,66 @@
+/*******************************************************************************
+ Filename:                  Compositor.h
+ Classname:                 Compositor
+
+ Description:               This file declares the Compositor class. The
+                            Compositor draws parts of a frame on a ThreadPool.
+                            The screen is split into tiles, and every part to
+                            draw into pieces along them; each piece is handed
+                            the items of a DrawList whose bounds touch it, in
+                            layer order, and draws the background and those
+                            items clipped to itself, through a surface of its
+                            own that shares the screen's pixels. Pieces never
+                            overlap and Blitter::blit only writes pixels, so
+                            they run side by side and the frame comes out the
+                            same, pixel for pixel, as drawn on one thread.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Compositor_h
+#define AngrySomething_Compositor_h
+
+#include <vector>
+#include <SDL/SDL.h>
+
+#include "DrawList.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+class Compositor : public ThreadTask
+{
+    private:
+        struct Piece
+        {
+            SDL_Rect    rect;
+            int         first;      //objects, in binned
+            int         count;
+        };
+
+        int                     tileW;
+        int                     tileH;
+
+        //the frame in progress
+        DrawList*               list;
+        vector<Piece>           pieces;
+        vector<int>             binned;
+        vector<SDL_Surface*>    views;      //one per piece, kept for reuse
+
+        void    split(SDL_Rect r);
+        void    makeViews(SDL_Surface* screen);
+
+        Compositor(const Compositor&);
+        Compositor& operator=(const Compositor&);
+
+    public:
+        Compositor();
+        ~Compositor();
+
+        void    draw(SDL_Surface* screen, DrawList& frame, vector<SDL_Rect>& regions,
+                     ThreadPool& pool);
+        void    runTask(int i);
+
+        void    setTileSize(int w, int h);
+        int     getNumPieces() {return (int)pieces.size();}
+};
+
+#endif
@@ -0,0 +1,470 @@
+/*******************************************************************************
+ Filename:                  ContactSolver.cpp
+ Classname:                 ContactSolver
+
+ Description:               This file defines the ContactSolver class. The
+                            ContactSolver resolves the contacts found by the
+                            PhysicsEngine with sequential impulses: every
+                            contact is visited several times per tick, each
+                            visit correcting the velocities of its two bodies
+                            a little. Impulses are cached per body pair and
+                            reapplied at the start of the next tick (warm
+                            starting), so resting stacks settle instead of
+                            being solved from scratch every tick. Contacts are
+                            split into islands (sets of bodies touching each
+                            other) that share no bodies, and the islands are
+                            solved concurrently on a ThreadPool. Each island
+                            is solved in the same order whatever the thread
+                            count, so results do not depend on it.
+ ******************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include "ContactSolver.h"
+
+const double BODY_BOUNCE    = .1;   //restitution between two bodies
+const double EDGE_BOUNCE    = .6;   //restitution against the edge of the field
+const double BOUNCE_MIN     = 1.5;  //slower hits than this do not bounce
+const double FRICTION       = .5;
+const double SLOP           = 1;    //overlap in pixels left alone
+const double CORRECTION     = 1;    //fraction of the remaining overlap removed
+
+/*******************************************************************************
+ Name:              ContactSolver
+ Description:       Constructor
+
+ Input:
+    iter            Solver passes per tick
+ ******************************************************************************/
+ContactSolver::ContactSolver(int iter)
+{
+    iterations = iter;
+    numWarm    = 0;
+    store      = NULL;
+}
+
+void ContactSolver::setIterations(int iter)
+{
+    if(iter > 0)
+        iterations = iter;
+}
+
+/*******************************************************************************
+ Name:              clear
+ Description:       Drops the contacts of the last tick. The impulse cache is
+                    kept until solve() replaces it, unless the bodies now come
+                    from another world, whose serials mean something else.
+
+ Input:
+    bodies          BodyStore of the World being stepped
+ ******************************************************************************/
+void ContactSolver::clear(BodyStore& bodies)
+{
+    contacts.clear();
+
+    if(store != &bodies)
+        cache.clear();
+    store = &bodies;
+}
+
+/*******************************************************************************
+ Name:              invMass, velOf
+ Description:       Paused bodies, and the edge of the field (NULL), are
+                    treated as immovable
+ ******************************************************************************/
+double ContactSolver::invMass(PhysicalObject* obj)
+{
+    if(!obj || !obj->getActivePhys() || obj->isAsleep())
+        return 0;
+    return 1.0 / obj->getMass();
+}
+
+Vect ContactSolver::velOf(PhysicalObject* obj)
+{
+    if(!obj)
+        return Vect(0, 0);
+    return store->getVel(obj->getBody());
+}
+
+/*******************************************************************************
+ Name:              add, addEdge
+ Description:       Queue a contact for this tick
+
+ Input:
+    a, b            The bodies touching
+    c               Contact normal (from a to b) and depth
+    side            Which edge of the field a is touching
+ ******************************************************************************/
+void ContactSolver::add(PhysicalObject* a, PhysicalObject* b, Contact c)
+{
+    if(invMass(a) == 0 && invMass(b) == 0)
+        return;
+
+    BodyContact bc;
+    bc.a      = a;
+    bc.b      = b;
+    bc.normal = c.normal;
+    bc.depth  = c.depth;
+    bc.keyA   = store->getSerial(a->getBody());
+    bc.keyB   = store->getSerial(b->getBody());
+
+    contacts.push_back(bc);
+}
+
+void ContactSolver::addEdge(PhysicalObject* a, Vect normal, double depth, int side)
+{
+    if(invMass(a) == 0)
+        return;
+
+    BodyContact bc;
+    bc.a      = a;
+    bc.b      = NULL;
+    bc.normal = normal;
+    bc.depth  = depth;
+    bc.keyA   = store->getSerial(a->getBody());
+    bc.keyB   = -1 - side;
+
+    contacts.push_back(bc);
+}
+
+/*******************************************************************************
+ Name:              push
+ Description:       Applies a normal and a tangent impulse to a contact's
+                    bodies, a pushed back and b pushed forward
+ ******************************************************************************/
+void ContactSolver::push(BodyContact& c, double jn, double jt)
+{
+    Vect t(-c.normal.y, c.normal.x);
+    Vect j = c.normal * jn + t * jt;
+
+    double ia = invMass(c.a);
+    double ib = invMass(c.b);
+
+    if(ia)
+        store->setVel(c.a->getBody(), store->getVel(c.a->getBody()) + j * -ia);
+    if(ib)
+        store->setVel(c.b->getBody(), store->getVel(c.b->getBody()) + j * ib);
+}
+
+/*******************************************************************************
+ Name:              findRoot, findIslands
+ Description:       Union-find over the BodyStore slots of the contacts'
+                    bodies. The contacts are then grouped by island, keeping
+                    the order they were added in within each island, and
+                    bodies touching the edge of the field are marked pinned.
+ ******************************************************************************/
+int ContactSolver::findRoot(int i)
+{
+    while(islandOf[i] != i)
+    {
+        islandOf[i] = islandOf[islandOf[i]];
+        i = islandOf[i];
+    }
+    return i;
+}
+
+static bool largerIsland(const pair<int, int>& p, const pair<int, int>& q)
+{
+    return p.first > q.first;
+}
+
+void ContactSolver::findIslands()
+{
+    int n = (int)contacts.size();
+    int slots = store->size();
+
+    islandOf.resize(slots);
+    pinned.resize(slots);
+
+    for(int i = 0; i < n; i++)
+    {
+        BodyContact& c = contacts[i];
+
+        islandOf[c.a->getBody()] = c.a->getBody();
+        pinned[c.a->getBody()]   = 0;
+        if(c.b)
+        {
+            islandOf[c.b->getBody()] = c.b->getBody();
+            pinned[c.b->getBody()]   = 0;
+        }
+    }
+
+    //join the bodies of every contact
+    for(int i = 0; i < n; i++)
+    {
+        BodyContact& c = contacts[i];
+
+        if(!c.b)
+        {
+            pinned[c.a->getBody()] = 1;
+            continue;
+        }
+
+        int ra = findRoot(c.a->getBody());
+        int rb = findRoot(c.b->getBody());
+
+        if(ra < rb)       islandOf[rb] = ra;
+        else if(rb < ra)  islandOf[ra] = rb;
+    }
+
+    //number the islands in order of their first contact
+    vector<int> island(n);
+    vector<int> size;
+    map<int, int> number;
+
+    for(int i = 0; i < n; i++)
+    {
+        int root = findRoot(contacts[i].a->getBody());
+        map<int, int>::iterator it = number.find(root);
+
+        if(it == number.end())
+        {
+            it = number.insert(make_pair(root, (int)size.size())).first;
+            size.push_back(0);
+        }
+
+        island[i] = it->second;
+        size[it->second]++;
+    }
+
+    //counting sort of the contacts by island
+    int num = (int)size.size();
+
+    islandStart.assign(num + 1, 0);
+    for(int k = 0; k < num; k++)
+        islandStart[k + 1] = islandStart[k] + size[k];
+
+    vector<int> fill(islandStart.begin(), islandStart.end() - 1);
+
+    order.resize(n);
+    for(int i = 0; i < n; i++)
+        order[fill[island[i]]++] = i;
+
+    //hand the big islands out first so no thread is left with one at the end
+    vector< pair<int, int> > sizes(num);
+    for(int k = 0; k < num; k++)
+        sizes[k] = make_pair(size[k], k);
+    stable_sort(sizes.begin(), sizes.end(), largerIsland);
+
+    bySize.resize(num);
+    for(int k = 0; k < num; k++)
+        bySize[k] = sizes[k].second;
+
+    islandWarm.assign(num, 0);
+}
+
+/*******************************************************************************
+ Name:              prepare
+ Description:       Works out each contact's effective masses and bounce,
+                    reports the hit to both bodies and warm starts it with the
+                    impulse it ended the last tick with
+
+ Input:
+    first, last     Range of order[] to prepare
+
+ Output:
+    returns         Number of contacts warm started
+ ******************************************************************************/
+int ContactSolver::prepare(int first, int last)
+{
+    int warm = 0;
+
+    for(int k = first; k < last; k++)
+    {
+        BodyContact& c = contacts[order[k]];
+
+        double ia = invMass(c.a);
+        double ib = invMass(c.b);
+
+        c.massN = 1 / (ia + ib);
+        c.massT = c.massN;
+
+        Vect   rel = velOf(c.b) + velOf(c.a) * -1;
+        double vn  = rel.dot(c.normal);
+
+        double e = c.b ? BODY_BOUNCE : EDGE_BOUNCE;
+        c.bounce = (vn < -BOUNCE_MIN) ? -e * vn : 0;
+
+        //let gameplay objects take damage from the hit
+        if(vn < 0)
+        {
+            c.a->impact(rel);
+            if(c.b)
+                c.b->impact(rel * -1);
+        }
+
+        //whichever body rests on top of the other counts as grounded
+        if(c.normal.y > .5)
+            c.a->setCollisionSide(BOTTOM);
+        else if(c.normal.y < -.5 && c.b)
+            c.b->setCollisionSide(BOTTOM);
+
+        c.accN = c.accT = 0;
+
+        int lo = c.keyA < c.keyB ? c.keyA : c.keyB;
+        int hi = c.keyA < c.keyB ? c.keyB : c.keyA;
+
+        //only read while islands are solved, so safe to share
+        map<pair<int, int>, CachedImpulse>::const_iterator it = cache.find(make_pair(lo, hi));
+
+        if(it != cache.end())
+        {
+            c.accN = it->second.accN;
+            c.accT = it->second.accT;
+            push(c, c.accN, c.accT);
+            warm++;
+        }
+    }
+
+    return warm;
+}
+
+/*******************************************************************************
+ Name:              solveOnce
+ Description:       One pass over the contacts of an island. The normal
+                    impulse stops the bodies closing (plus any bounce) and may
+                    only push; the friction impulse is limited by the normal
+                    one.
+ ******************************************************************************/
+void ContactSolver::solveOnce(int first, int last)
+{
+    for(int k = first; k < last; k++)
+    {
+        BodyContact& c = contacts[order[k]];
+
+        Vect rel = velOf(c.b) + velOf(c.a) * -1;
+        Vect t(-c.normal.y, c.normal.x);
+
+        //normal
+        double vn  = rel.dot(c.normal);
+        double jn  = c.massN * (c.bounce - vn);
+        double old = c.accN;
+
+        c.accN = max(old + jn, 0.0);
+        jn = c.accN - old;
+
+        //friction
+        rel = rel + c.normal * (jn * (invMass(c.a) + invMass(c.b)));
+
+        double vt    = rel.dot(t);
+        double jt    = -c.massT * vt;
+        double limit = FRICTION * c.accN;
+
+        old = c.accT;
+        c.accT = old + jt;
+        if(c.accT > limit)  c.accT = limit;
+        if(c.accT < -limit) c.accT = -limit;
+        jt = c.accT - old;
+
+        push(c, jn, jt);
+    }
+}
+
+/*******************************************************************************
+ Name:              storeImpulses
+ Description:       Replaces the cache with the impulses of this tick; pairs
+                    that stopped touching drop out
+ ******************************************************************************/
+void ContactSolver::storeImpulses()
+{
+    cache.clear();
+
+    for(int i = 0; i < (int)contacts.size(); i++)
+    {
+        BodyContact& c = contacts[i];
+
+        int lo = c.keyA < c.keyB ? c.keyA : c.keyB;
+        int hi = c.keyA < c.keyB ? c.keyB : c.keyA;
+
+        CachedImpulse ci;
+        ci.accN = c.accN;
+        ci.accT = c.accT;
+        cache[make_pair(lo, hi)] = ci;
+    }
+}
+
+/*******************************************************************************
+ Name:              correctPositions
+ Description:       Moves overlapping bodies apart by whole pixels, split by
+                    inverse mass. Positions are integers, so overlaps up to
+                    SLOP are left for the velocities to hold. A body touching
+                    the edge of the field is not moved, or the correction
+                    would push it through the edge.
+ ******************************************************************************/
+void ContactSolver::correctPositions(int first, int last)
+{
+    for(int k = first; k < last; k++)
+    {
+        BodyContact& c = contacts[order[k]];
+
+        if(!c.b || c.depth <= SLOP)
+            continue;
+
+        double ia = pinned[c.a->getBody()] ? 0 : invMass(c.a);
+        double ib = pinned[c.b->getBody()] ? 0 : invMass(c.b);
+
+        if(ia + ib == 0)
+            continue;
+
+        double d  = (c.depth - SLOP) * CORRECTION / (ia + ib);
+
+        if(ia)
+        {
+            SDL_Rect p = c.a->getPos();
+            p.x -= (Sint16)round(c.normal.x * d * ia);
+            p.y -= (Sint16)round(c.normal.y * d * ia);
+            c.a->setPos(p);
+        }
+        if(ib)
+        {
+            SDL_Rect p = c.b->getPos();
+            p.x += (Sint16)round(c.normal.x * d * ib);
+            p.y += (Sint16)round(c.normal.y * d * ib);
+            c.b->setPos(p);
+        }
+    }
+}
+
+/*******************************************************************************
+ Name:              runTask
+ Description:       Solves one island start to finish. Called from the
+                    ThreadPool; islands share no bodies, so they can run at
+                    the same time.
+
+ Input:
+    i               Island, counting from the largest
+ ******************************************************************************/
+void ContactSolver::runTask(int i)
+{
+    int k     = bySize[i];
+    int first = islandStart[k];
+    int last  = islandStart[k + 1];
+
+    islandWarm[k] = prepare(first, last);
+
+    for(int it = 0; it < iterations; it++)
+        solveOnce(first, last);
+
+    correctPositions(first, last);
+}
+
+/*******************************************************************************
+ Name:              solve
+ Description:       Resolves every contact queued this tick
+
+ Input:
+    pool            Threads to solve the islands on
+ ******************************************************************************/
+void ContactSolver::solve(ThreadPool& pool)
+{
+    findIslands();
+
+    pool.run(this, getNumIslands());
+
+    numWarm = 0;
+    for(int k = 0; k < getNumIslands(); k++)
+        numWarm += islandWarm[k];
+
+    storeImpulses();
+}
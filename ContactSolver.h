@@ -0,0 +1,101 @@
+/*******************************************************************************
+ Filename:                  ContactSolver.h
+ Classname:                 ContactSolver
+
+ Description:               This file declares the ContactSolver class. The
+                            ContactSolver resolves the contacts found by the
+                            PhysicsEngine with sequential impulses: every
+                            contact is visited several times per tick, each
+                            visit correcting the velocities of its two bodies
+                            a little. Impulses are cached per body pair and
+                            reapplied at the start of the next tick (warm
+                            starting), so resting stacks settle instead of
+                            being solved from scratch every tick. Contacts are
+                            split into islands (sets of bodies touching each
+                            other) that share no bodies, and the islands are
+                            solved concurrently on a ThreadPool. Each island
+                            is solved in the same order whatever the thread
+                            count, so results do not depend on it.
+ ******************************************************************************/
+
+#ifndef AngrySomething_ContactSolver_h
+#define AngrySomething_ContactSolver_h
+
+#include <vector>
+#include <map>
+
+#include "PhysicalObject.h"
+#include "Geometry.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+struct BodyContact
+{
+    PhysicalObject* a;
+    PhysicalObject* b;          //NULL when a touches the edge of the field
+    Vect            normal;     //unit vector from a to b
+    double          depth;
+    int             keyA;       //BodyStore serials, or -1 - side for the field
+    int             keyB;
+
+    //filled in by the solver
+    double          massN;
+    double          massT;
+    double          bounce;
+    double          accN;
+    double          accT;
+};
+
+struct CachedImpulse
+{
+    double          accN;
+    double          accT;
+};
+
+class ContactSolver : public ThreadTask
+{
+    private:
+        vector<BodyContact>                 contacts;
+        map<pair<int, int>, CachedImpulse>  cache;
+        BodyStore*                          store;
+        int                                 iterations;
+        int                                 numWarm;
+
+        //islands of this tick, indexed by BodyStore slot where per body
+        vector<int>                         islandOf;
+        vector<char>                        pinned;
+        vector<int>                         order;      //contacts, by island
+        vector<int>                         islandStart;
+        vector<int>                         islandWarm;
+        vector<int>                         bySize;     //largest island first
+
+        double  invMass(PhysicalObject* obj);
+        Vect    velOf(PhysicalObject* obj);
+        void    push(BodyContact& c, double jn, double jt);
+
+        int     findRoot(int i);
+        void    findIslands();
+
+        int     prepare(int first, int last);
+        void    solveOnce(int first, int last);
+        void    correctPositions(int first, int last);
+        void    storeImpulses();
+
+    public:
+        ContactSolver(int iter = 8);
+
+        void    clear(BodyStore& bodies);
+        void    add(PhysicalObject* a, PhysicalObject* b, Contact c);
+        void    addEdge(PhysicalObject* a, Vect normal, double depth, int side);
+        void    solve(ThreadPool& pool);
+        void    runTask(int i);
+
+        void    setIterations(int iter);
+        int     getIterations() {return iterations;}
+        int     getNumContacts() {return (int)contacts.size();}
+        int     getNumIslands() {return (int)islandStart.size() - 1;}
+        int     getNumWarmStarted() {return numWarm;}
+};
+
+#endif
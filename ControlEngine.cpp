@@ -2,22 +2,39 @@
 
 void ControlEngine::run(Room& room)
 {
-    Object* obj;
+    vector<ControllableObject*>& cont = room.getControllables();
 
-    if(SDL_PollEvent(&event))
+    input = SDL_PollEvent(&event) != 0;
+
+    if(input)
     {
+        //Game ends the loop, so its engines and threads shut down first
         if( event.type == SDL_QUIT )
         {
-            exit(0);
+            quit = true;
+            return;
         }
 
-        for(int i = 0; i < room.getNumObjects(); i++)
+        //objects in the field get the mouse where it points in the field
+        SDL_Event inField = event;
+        SDL_Rect  view    = room.getCamera().getShown();
+
+        if(event.type == SDL_MOUSEMOTION)
+        {
+            inField.motion.x += view.x;
+            inField.motion.y += view.y;
+        }
+        else if(event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP)
         {
-            obj = room.getObjectAt(i);
+            inField.button.x += view.x;
+            inField.button.y += view.y;
+        }
 
-            if(obj->isControllable() && obj->getActiveCont())
+        for(int i = 0; i < (int)cont.size(); i++)
+        {
+            if(cont[i]->getActiveCont())
             {
-                dynamic_cast<ControllableObject*>(obj)->handle(event);
+                cont[i]->handle(cont[i]->isFixed() ? event : inField);
             }
         }
     }
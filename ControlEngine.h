@@ -7,9 +7,15 @@ class ControlEngine
 {
     private:
         SDL_Event event;
+        bool input;     //an event came last run
+        bool quit;      //the window was closed
 
     public:
+        ControlEngine() {input = false; quit = false;}
+
         void run(Room& room);
+        bool hadInput() {return input;}
+        bool hadQuit() {return quit;}
 };
 
 #endif // CONTROLENGINE_H
@@ -14,8 +14,6 @@ DestructableWall::DestructableWall(const char* file, int x, int y, int vx, int v
 
 void DestructableWall::run()
 {
-    move();
-
     if(health <= 0)
     {
         state = -1;
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ Filename:                  DrawList.cpp
+ Classname:                 DrawList
+
+ Description:               This file defines the DrawList class.
+ ******************************************************************************/
+
+#include "DrawList.h"
+#include "Blitter.h"
+#include "TextureCache.h"
+#include "TextCache.h"
+
+/*******************************************************************************
+ Name:              DrawList
+ Description:       Constructor
+ ******************************************************************************/
+DrawList::DrawList()
+{
+    clear();
+}
+
+DrawList::~DrawList()
+{
+    clear();
+}
+
+/*******************************************************************************
+ Name:              clear
+ Description:       Empties the list, keeping its memory, and gives back its
+                    surfaces
+ ******************************************************************************/
+void DrawList::clear()
+{
+    for(int i = 0; i < (int)held.size(); i++)
+    {
+        TextureCache::release(held[i]);
+        TextCache::release(held[i]);
+    }
+
+    held.clear();
+    items.clear();
+    commands.clear();
+
+    room       = NULL;
+    background = NULL;
+    bgX        = 0;
+    bgY        = 0;
+    dx         = 0;
+    dy         = 0;
+
+    view.x = view.y = 0;
+    view.w = view.h = 0;
+}
+
+/*******************************************************************************
+ Name:              hold
+ Description:       Takes a reference to a surface from either cache; others
+                    are not counted
+ ******************************************************************************/
+void DrawList::hold(SDL_Surface* s)
+{
+    TextureCache::addRef(s);
+    TextCache::addRef(s);
+    held.push_back(s);
+}
+
+/*******************************************************************************
+ Name:              setRoom
+ Description:       Sets the room the frame is of, and its background
+ ******************************************************************************/
+void DrawList::setRoom(Room* r, SDL_Surface* bg)
+{
+    room       = r;
+    background = bg;
+
+    if(bg)
+        hold(bg);
+}
+
+/*******************************************************************************
+ Name:              add
+ Description:       Writes down a blit to the current item, with the same
+                    arguments as Blitter::blit, moved by the offset
+ ******************************************************************************/
+void DrawList::add(SDL_Surface* src, SDL_Rect* srcrect, SDL_Rect* dstrect)
+{
+    BlitCommand c;
+
+    c.src   = src;
+    c.whole = srcrect == NULL;
+    c.x     = (dstrect ? dstrect->x : 0) + dx;
+    c.y     = (dstrect ? dstrect->y : 0) + dy;
+
+    if(srcrect)
+        c.from = *srcrect;
+
+    commands.push_back(c);
+
+    if(!items.empty())
+        items.back().count++;
+
+    hold(src);
+}
+
+/*******************************************************************************
+ Name:              replay
+ Description:       Makes an item's blits onto a surface, clipped to its clip
+                    rectangle. Any thread may replay a list nobody is filling.
+ ******************************************************************************/
+void DrawList::replay(DrawItem& item, SDL_Surface* dst)
+{
+    for(int i = item.first; i < item.first + item.count; i++)
+    {
+        BlitCommand& c = commands[i];
+        SDL_Rect     from = c.from;
+        SDL_Rect     to;
+
+        to.x = c.x;
+        to.y = c.y;
+
+        Blitter::blit(c.src, c.whole ? NULL : &from, dst, &to);
+    }
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ Filename:                  DrawList.h
+ Classname:                 DrawList
+
+ Description:               This file declares the DrawList class. A DrawList
+                            is a frame written down: the background, and for
+                            each object in layer order its Handle, its bounds
+                            and the blits its draw method made, all moved
+                            from the field onto the screen. The
+                            GraphicsEngine records one on the game thread and
+                            draws it on its render thread, so drawing never
+                            reads an object the game may be changing. A
+                            DrawList takes a reference to every surface it
+                            names, so none is freed while it may still be
+                            drawn; only the game thread may fill or clear one.
+ ******************************************************************************/
+
+#ifndef AngrySomething_DrawList_h
+#define AngrySomething_DrawList_h
+
+#include <vector>
+#include <SDL/SDL.h>
+
+#include "Handle.h"
+
+class Room;
+
+using namespace std;
+
+/*******************************************************************************
+ Struct BlitCommand
+ Description:       One blit: the surface, the part of it (all of it when
+                    whole), and where it goes
+ ******************************************************************************/
+struct BlitCommand
+{
+    SDL_Surface*    src;
+    SDL_Rect        from;
+    bool            whole;
+    Sint16          x;
+    Sint16          y;
+};
+
+/*******************************************************************************
+ Struct DrawItem
+ Description:       One object: what the dirty rectangle pass compares, and
+                    its blits, commands[first] on
+ ******************************************************************************/
+struct DrawItem
+{
+    Handle          handle;
+    SDL_Rect        bounds;
+    bool            changed;
+    int             first;
+    int             count;
+};
+
+class DrawList
+{
+    private:
+        vector<SDL_Surface*>    held;
+        int                     dx, dy;     //added to blits as they come
+
+        void    hold(SDL_Surface* s);
+
+        DrawList(const DrawList&);
+        DrawList& operator=(const DrawList&);
+
+    public:
+        Room*                   room;       //only to tell rooms apart
+        SDL_Surface*            background;
+        int                     bgX, bgY;   //background pixel at the top left
+        SDL_Rect                view;       //the part of the field shown
+        vector<DrawItem>        items;
+        vector<BlitCommand>     commands;
+
+        DrawList();
+        ~DrawList();
+
+        void    clear();
+        void    setRoom(Room* r, SDL_Surface* bg);
+        void    setOffset(int x, int y) {dx = x; dy = y;}
+        void    add(SDL_Surface* src, SDL_Rect* srcrect, SDL_Rect* dstrect);
+        void    replay(DrawItem& item, SDL_Surface* dst);
+};
+
+#endif
@@ -4,9 +4,13 @@
 
  Description:               This file defines the DrawableObject class.
  ******************************************************************************/
-#include <iostream>
-
 #include "DrawableObject.h"
+#include "TextureCache.h"
+#include "FontManager.h"
+#include "TextCache.h"
+#include "Geometry.h"
+
+#include <algorithm>
 
 using namespace std;
 
@@ -17,36 +21,26 @@ using namespace std;
 DrawableObject::DrawableObject(const char* file, int l = 0)
 {
     drawable = true;
+    layer    = l;
+    changed  = false;
 
-    image = SDL_LoadBMP(file);
+    image   = NULL;
+    message = NULL;
+    font    = NULL;
 
-    if(!image)
-    {
-        cout << SDL_GetError() << endl;
-    }
+    frame.x = frame.y = 0;
+    frame.w = frame.h = 0;
 
-    layer = l;
+    if(isHeadless())
+        return;
 
-    Uint32 colorkey = SDL_MapRGB( image->format, 0xFF, 0xAE, 0xC9);
-    SDL_SetColorKey( image, SDL_SRCCOLORKEY, colorkey );
-    
-    //Initialize SDL_ttf
-    if(TTF_Init() == -1)
-    {
-        cout << SDL_GetError() << endl;
-    }
-    
-    //Initialize Message and Font
-    message = NULL;
-    font    = NULL;
-    
-    //Open font
-    font = TTF_OpenFont("font.ttf", 14);
+    //shared with every other object drawn from the same file or atlas
+    Sprite sprite = TextureCache::acquireSprite(file);
+    image = sprite.surface;
+    frame = sprite.rect;
     
-    if(font == NULL)
-    {
-        cout << SDL_GetError() << endl;
-    }
+    //Open font, once for every object
+    font = FontManager::getFont("font.ttf", 14);
     
     //Set Font Color
     fontColor.r = 255;
@@ -63,7 +57,16 @@ DrawableObject::DrawableObject(const char* file, int l = 0)
  ******************************************************************************/
 DrawableObject::DrawableObject(const DrawableObject& other)
 {
-    *image = *(other.image);
+    drawable  = true;
+    layer     = other.layer;
+    changed   = false;
+    fontColor = other.fontColor;
+    message   = NULL;
+    font      = other.font;
+
+    image = other.image;
+    frame = other.frame;
+    TextureCache::addRef(image);
 }
 
 /*******************************************************************************
@@ -72,9 +75,8 @@ DrawableObject::DrawableObject(const DrawableObject& other)
  ******************************************************************************/
 DrawableObject::~DrawableObject()
 {
-    SDL_FreeSurface(image);
-    SDL_FreeSurface(message);
-    TTF_CloseFont(font);
+    TextureCache::release(image);
+    TextCache::release(message);
 }
 
 /*******************************************************************************
@@ -88,34 +90,121 @@ DrawableObject& DrawableObject::operator=(const DrawableObject& other)
 {
     if(&other != this)
     {
-        *image = *(other.image);
+        TextureCache::addRef(other.image);
+        TextureCache::release(image);
+        image = other.image;
+        frame = other.frame;
+        layer = other.layer;
     }
 
     return *this;
 }
 
+/*******************************************************************************
+ Name:              prepare
+ Description:       Called by the GraphicsEngine before each frame, so
+                    anything draw needs is made before the engine works out
+                    what has to be redrawn. Set changed if the object will
+                    look different without moving.
+ ******************************************************************************/
+void DrawableObject::prepare()
+{
+    //rendered the first time only
+    if(message == NULL)
+    {
+        message = TextCache::acquire(font, ":)", fontColor);
+        changed = true;
+    }
+}
+
 /*******************************************************************************
  Name:              draw
- Description:       Draws the Object to the given SDL_Surface*
+ Description:       Draws the Object to the given SDL_Surface*. The object
+                    shows the part of its picture under it, and the picture
+                    repeats across the field, so an object past its right
+                    or bottom edge on a large field still has one.
 
  Input:
     s               SDL_Surface* to be drawn onto
  ******************************************************************************/
 void DrawableObject::draw(SDL_Surface* s)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect messageLoc = pos;  //a blit clips loc to the screen
 
-    SDL_BlitSurface(image, &pos, s, &loc);
+    int left   = max((int)pos.x, 0);
+    int top    = max((int)pos.y, 0);
+    int right  = pos.x + pos.w;
+    int bottom = pos.y + pos.h;
 
-    message = TTF_RenderText_Solid(font, ":)", fontColor);
-    
-    if(message == NULL)
+    //one blit per copy of the picture the object covers, which may be in
+    //an atlas; on the screen's part of the field that is one blit
+    for(int y = top; frame.h > 0 && y < bottom; )
     {
-        cout << "Bad." << endl;    
+        int fy = y % frame.h;
+        int h  = min((int)frame.h - fy, bottom - y);
+
+        for(int x = left; frame.w > 0 && x < right; )
+        {
+            int fx = x % frame.w;
+            int w  = min((int)frame.w - fx, right - x);
+
+            SDL_Rect src, loc;
+
+            src.x = frame.x + fx;
+            src.y = frame.y + fy;
+            src.w = w;
+            src.h = h;
+            loc.x = x;
+            loc.y = y;
+
+            Blitter::blit(image, &src, s, &loc);
+
+            x += w;
+        }
+
+        y += h;
     }
-    
-    SDL_BlitSurface(message, NULL, s, &loc);
+
+    Blitter::blit(message, NULL, s, &messageLoc);
+}
+
+/*******************************************************************************
+ Name:              getBounds
+ Description:       Everything draw can touch on the screen: the part of the
+                    image under the object, and the message. Objects that
+                    draw something else override this.
+ ******************************************************************************/
+SDL_Rect DrawableObject::getBounds()
+{
+    SDL_Rect r = pos;
+
+    if(message)
+    {
+        SDL_Rect m = pos;
+        m.w = message->w;
+        m.h = message->h;
+        r = unite(r, m);
+    }
+
+    return r;
+}
+
+/*******************************************************************************
+ Name:              imageBounds
+ Description:       Bounds of the whole image drawn at the object's position,
+                    for objects whose draw blits all of it
+ ******************************************************************************/
+SDL_Rect DrawableObject::imageBounds()
+{
+    SDL_Rect r = pos;
+
+    if(image)
+    {
+        r.w = frame.w;
+        r.h = frame.h;
+    }
+
+    return r;
 }
 
 int DrawableObject::getLayer()
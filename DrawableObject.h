@@ -12,15 +12,21 @@
 #include "SDL_ttf/SDL_ttf.h"
 
 #include "Object.h"
+#include "TextureCache.h"
+#include "Blitter.h"
 
 class DrawableObject : virtual public Object
 {
     protected:
         SDL_Surface*    image;
+        SDL_Rect        frame;      //where on image this object's picture is
         SDL_Surface*    message;
         TTF_Font*       font;
         SDL_Color       fontColor;
         int             layer;
+        bool            changed;    //looks different at the same bounds
+
+        SDL_Rect        imageBounds();
 
     public:
         DrawableObject(const char* file, int);
@@ -29,7 +35,12 @@ class DrawableObject : virtual public Object
 
         DrawableObject& operator=(const DrawableObject& other);
 
+        virtual void    prepare();
         virtual void    draw(SDL_Surface*);
+        virtual SDL_Rect getBounds();
+
+        bool            isChanged() {return changed;}
+        void            clearChanged() {changed = false;}
 
         int             getLayer();
 };
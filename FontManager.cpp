@@ -0,0 +1,78 @@
+/*******************************************************************************
+ Filename:                  FontManager.cpp
+ Classname:                 FontManager
+
+ Description:               This file defines the FontManager class.
+ ******************************************************************************/
+
+#include <iostream>
+
+#include "FontManager.h"
+
+map<pair<string, int>, TTF_Font*>   FontManager::fonts;
+bool                                FontManager::started = false;
+
+/*******************************************************************************
+ Name:              getFont
+ Description:       Finds an open font, or opens it
+
+ Input:
+    file            The .ttf file
+    size            Point size
+
+ Output:
+    returns         The shared font, or NULL if it could not be opened. Do
+                    not close it.
+ ******************************************************************************/
+TTF_Font* FontManager::getFont(const char* file, int size)
+{
+    pair<string, int> key(file, size);
+    map<pair<string, int>, TTF_Font*>::iterator it = fonts.find(key);
+
+    if(it != fonts.end())
+        return it->second;
+
+    if(!started)
+    {
+        if(TTF_Init() == -1)
+        {
+            cout << SDL_GetError() << endl;
+            return NULL;
+        }
+        started = true;
+    }
+
+    TTF_Font* font = TTF_OpenFont(file, size);
+
+    if(font == NULL)
+    {
+        cout << SDL_GetError() << endl;
+    }
+
+    //a font that failed stays NULL, so it is only tried once
+    fonts[key] = font;
+
+    return font;
+}
+
+/*******************************************************************************
+ Name:              shutdown
+ Description:       Closes every font and stops SDL_ttf
+ ******************************************************************************/
+void FontManager::shutdown()
+{
+    map<pair<string, int>, TTF_Font*>::iterator it;
+
+    for(it = fonts.begin(); it != fonts.end(); ++it)
+    {
+        if(it->second)
+            TTF_CloseFont(it->second);
+    }
+    fonts.clear();
+
+    if(started)
+    {
+        TTF_Quit();
+        started = false;
+    }
+}
@@ -0,0 +1,32 @@
+/*******************************************************************************
+ Filename:                  FontManager.h
+ Classname:                 FontManager
+
+ Description:               This file declares the FontManager class. The
+                            FontManager starts SDL_ttf once and opens each
+                            font file at each size once for the whole process;
+                            every object asking for the same font gets the
+                            same TTF_Font. Fonts stay open until shutdown().
+ ******************************************************************************/
+
+#ifndef AngrySomething_FontManager_h
+#define AngrySomething_FontManager_h
+
+#include <map>
+#include <string>
+#include "SDL_ttf/SDL_ttf.h"
+
+using namespace std;
+
+class FontManager
+{
+    private:
+        static map<pair<string, int>, TTF_Font*>    fonts;
+        static bool                                 started;
+
+    public:
+        static TTF_Font*    getFont(const char* file, int size);
+        static void         shutdown();
+};
+
+#endif
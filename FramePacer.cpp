@@ -0,0 +1,218 @@
+/*******************************************************************************
+ Filename:                  FramePacer.cpp
+ Classname:                 FramePacer
+
+ Description:               This file defines the FramePacer class.
+ ******************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+
+#include "FramePacer.h"
+
+const int    DEFAULT_IDLE_RATE = 5;     //frames per second in low power mode
+const Uint32 IDLE_AFTER        = 2000;  //ms without motion or input
+const Uint32 IDLE_SLICE        = 20;    //ms slept between input checks
+
+/*******************************************************************************
+ Name:              FramePacer
+ Description:       Constructor. Low power mode starts on.
+
+ Input:
+    hz              Frames per second to aim for
+ ******************************************************************************/
+FramePacer::FramePacer(int hz)
+{
+    period     = 1000.0 / 60;
+    idlePeriod = 1000.0 / DEFAULT_IDLE_RATE;
+    lowPower   = true;
+    idling     = false;
+    next       = 0;
+    numFrames  = 0;
+    numIdle    = 0;
+
+    setRate(hz);
+    start();
+}
+
+/*******************************************************************************
+ Name:              setRate, setIdleRate
+ Description:       Sets the frames per second to aim for, at the full rate
+                    and in low power mode
+ ******************************************************************************/
+void FramePacer::setRate(int hz)
+{
+    if(hz > 0)
+        period = 1000.0 / hz;
+}
+
+void FramePacer::setIdleRate(int hz)
+{
+    if(hz > 0)
+        idlePeriod = 1000.0 / hz;
+}
+
+/*******************************************************************************
+ Name:              start
+ Description:       Starts the first frame now. Call just before the loop.
+ ******************************************************************************/
+void FramePacer::start()
+{
+    frameStart = SDL_GetTicks();
+    lastActive = frameStart;
+    deadline   = frameStart;
+    carry      = 0;
+    idling     = false;
+
+    advance(period);
+}
+
+/*******************************************************************************
+ Name:              advance
+ Description:       Moves the deadline on by a frame period. Whole ms go into
+                    deadline and the fraction is carried to the next frame,
+                    so a 60 Hz period still averages 16.67 ms.
+ ******************************************************************************/
+void FramePacer::advance(double ms)
+{
+    carry += ms;
+
+    Uint32 whole = (Uint32)carry;
+    deadline += whole;
+    carry    -= whole;
+}
+
+/*******************************************************************************
+ Name:              wait
+ Description:       Ends a frame: sleeps until the next one is due, and
+                    starts it
+
+ Input:
+    active          Something moved or input came this frame
+ ******************************************************************************/
+void FramePacer::wait(bool active)
+{
+    Uint32 now  = SDL_GetTicks();
+    Uint32 cost = now - frameStart;
+    bool   was  = idling;
+
+    if(active || !lowPower)
+        lastActive = now;
+
+    idling = lowPower && now - lastActive >= IDLE_AFTER;
+
+    if(idling != was)
+    {
+        deadline = frameStart;
+        carry    = 0;
+    }
+    advance(idling ? idlePeriod : period);
+
+    //late, start the next frame now rather than rush to catch up. Ticks wrap
+    //after about 49.7 days, so times are compared by signed difference.
+    if((Sint32)(now - deadline) > 0)
+    {
+        deadline = now;
+        carry    = 0;
+    }
+
+    sleepUntilDeadline();
+
+    Uint32 end = SDL_GetTicks();
+
+    if((int)times.size() < SAMPLES)
+    {
+        times.push_back(end - frameStart);
+        costs.push_back(cost);
+    }
+    else
+    {
+        times[next] = end - frameStart;
+        costs[next] = cost;
+    }
+    next = (next + 1) % SAMPLES;
+
+    numFrames++;
+    if(idling)
+        numIdle++;
+
+    frameStart = end;
+}
+
+/*******************************************************************************
+ Name:              sleepUntilDeadline
+ Description:       Sleeps until the next frame is due. In low power mode
+                    any input that arrives cuts the sleep short and returns
+                    to the full rate.
+ ******************************************************************************/
+void FramePacer::sleepUntilDeadline()
+{
+    Uint32 now = SDL_GetTicks();
+
+    while((Sint32)(deadline - now) > 0)
+    {
+        Uint32 left = deadline - now;
+
+        if(!idling)
+        {
+            SDL_Delay(left);
+            return;
+        }
+
+        SDL_Delay(min(left, IDLE_SLICE));
+
+        SDL_Event e;
+        SDL_PumpEvents();
+
+        now = SDL_GetTicks();
+
+        if(SDL_PeepEvents(&e, 1, SDL_PEEKEVENT, SDL_ALLEVENTS) > 0)
+        {
+            idling     = false;
+            lastActive = now;
+            deadline   = now;
+            carry      = 0;
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+ Name:              percentile
+ Description:       The sample p percent of the others are at or below
+
+ Input:
+    samples         Frame times or costs, in ms
+    p               0 to 100
+
+ Output:
+    returns         0 if there are no samples yet
+ ******************************************************************************/
+Uint32 FramePacer::percentile(vector<Uint32>& samples, double p)
+{
+    if(samples.empty())
+        return 0;
+
+    sorted = samples;
+
+    int k = (int)(p / 100 * (sorted.size() - 1) + .5);
+    k = max(0, min(k, (int)sorted.size() - 1));
+
+    nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+
+    return sorted[k];
+}
+
+/*******************************************************************************
+ Name:              report
+ Description:       Prints frame time and cost percentiles over the last
+                    frames, and how many frames were in low power mode
+ ******************************************************************************/
+void FramePacer::report()
+{
+    cout << "frames: " << numFrames << ", " << numIdle << " in low power; "
+         << "time 50/95/99% " << getTimePercentile(50) << "/"
+         << getTimePercentile(95) << "/" << getTimePercentile(99) << " ms, "
+         << "cost 50/95/99% " << getCostPercentile(50) << "/"
+         << getCostPercentile(95) << "/" << getCostPercentile(99) << " ms" << endl;
+}
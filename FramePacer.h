@@ -0,0 +1,76 @@
+/*******************************************************************************
+ Filename:                  FramePacer.h
+ Classname:                 FramePacer
+
+ Description:               This file declares the FramePacer class. The
+                            FramePacer ends each pass of the game loop: it
+                            measures what the frame cost and sleeps only the
+                            rest of the frame period, so a fast machine idles
+                            between frames and a slow one does not sleep at
+                            all.
+
+                            In low power mode, once nothing has moved and no
+                            input has come for a while, it drops to a few
+                            frames a second, sleeping in short slices that
+                            check for input, so the first event brings it back
+                            to the full rate at once.
+
+                            It keeps the last frames' times, start to start,
+                            and costs, start to sleep, for percentiles.
+ ******************************************************************************/
+
+#ifndef AngrySomething_FramePacer_h
+#define AngrySomething_FramePacer_h
+
+#include <vector>
+#include <SDL/SDL.h>
+
+using namespace std;
+
+class FramePacer
+{
+    private:
+        double          period;         //ms per frame at the full rate
+        double          idlePeriod;     //in low power mode
+        bool            lowPower;
+        bool            idling;
+        Uint32          frameStart;
+        Uint32          lastActive;
+        Uint32          deadline;       //when the next frame starts
+        double          carry;          //fraction of a ms deadline is behind
+
+        //the last SAMPLES frames, oldest overwritten first
+        vector<Uint32>  times;
+        vector<Uint32>  costs;
+        vector<Uint32>  sorted;
+        int             next;
+        long            numFrames;
+        long            numIdle;
+
+        void            advance(double ms);
+        void            sleepUntilDeadline();
+        Uint32          percentile(vector<Uint32>& samples, double p);
+
+    public:
+        static const int    SAMPLES = 256;
+
+        FramePacer(int hz = 60);
+
+        void            start();
+        void            wait(bool active);
+
+        void            setRate(int hz);
+        void            setIdleRate(int hz);
+        void            setLowPower(bool on) {lowPower = on;}
+        bool            getLowPower() {return lowPower;}
+        bool            isIdling() {return idling;}
+
+        Uint32          getTimePercentile(double p) {return percentile(times, p);}
+        Uint32          getCostPercentile(double p) {return percentile(costs, p);}
+        long            getNumFrames() {return numFrames;}
+        long            getNumIdleFrames() {return numIdle;}
+
+        void            report();
+};
+
+#endif
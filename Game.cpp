@@ -10,8 +10,14 @@
 
 #include <cstdlib>
 #include "Game.h"
+#include "TextureCache.h"
+#include "FontManager.h"
+#include "Blitter.h"
 using namespace std;
 
+const int DEFAULT_TICK_RATE   = 120;    //physics ticks per second
+const int MAX_TICKS_PER_FRAME = 8;      //keeps a slow frame from snowballing
+
 /*******************************************************************************
  Name:              Game
  Description:       Default constructor for Game class
@@ -19,6 +25,7 @@ using namespace std;
 Game::Game()
 {
     running = false;
+    tickRate = DEFAULT_TICK_RATE;
 }
 
 /*******************************************************************************
@@ -28,30 +35,100 @@ Game::Game()
  ******************************************************************************/
 void Game::init()
 {
+    //images packed by tools/PackAssets.cpp, and sprites packed by
+    //tools/PackAtlas.cpp, if they have been run
+    TextureCache::openArchive("Assets.pak");
+    TextureCache::loadAtlas("Sprites.atlas");
+
+    //the images of the levels that can be picked next are decoded on a
+    //thread of their own while the current screen is up
+    loader.start();
+    TextureCache::setPrefetcher(&loader);
+    state.setPrefetcher(&loader);
+
+    //frames are drawn on a thread of their own while the next tick runs
+    grph.setPipelined(true);
+
     running = room.load("TitleScreen.gel");
     room.setRoomType(Utility);
+    state.prefetchFrom(room);
+}
+
+/*******************************************************************************
+ Name:              setTickRate
+ Description:       Sets how many times per second the simulation is stepped,
+                    independent of how often the screen is drawn
+
+ Input:
+    hz              Ticks per second
+ ******************************************************************************/
+void Game::setTickRate(int hz)
+{
+    if(hz > 0)
+        tickRate = hz;
 }
 
 /*******************************************************************************
  Name:              run
- Description:       This method starts the game and controls the game loop
+ Description:       This method starts the game and controls the game loop.
+                    Mechanics and physics advance in fixed ticks of
+                    1 / tickRate seconds however long a frame takes; the
+                    screen is drawn once per loop, interpolated between the
+                    last two ticks, and the FramePacer sleeps out the rest
+                    of the frame, longer once the game has gone idle.
 
  Output:
     returns         int value representing the exit state of the game
  ******************************************************************************/
 int Game::run()
 {
+    Uint32 last = SDL_GetTicks();
+    double accumulator = 0;
+
+    pacer.start();
+
     while(running)
     {
+        double tick = 1000.0 / tickRate;
+        Uint32 now = SDL_GetTicks();
+        accumulator += now - last;
+        last = now;
+
         running = state.run(room);
         control.run(room);
-        mech.run(room);
-        phys.run(room);
-        grph.run(room);
+        running = running && !control.hadQuit();
+
+        int ticks = 0;
+        while(accumulator >= tick && ticks < MAX_TICKS_PER_FRAME)
+        {
+            mech.run(room);
+            phys.run(room);
+            room.getCamera().step(room.getWorld());
+            accumulator -= tick;
+            ticks++;
+        }
+
+        //too far behind to catch up, drop the backlog rather than stall
+        if(accumulator >= tick)
+            accumulator = 0;
+
+        grph.run(room, accumulator / tick);
         audi.run(room);
-        SDL_Delay(5);
+
+        pacer.wait(control.hadInput() || phys.getNumAwake() > 0 || !grph.isStill());
     }
 
+    grph.setPipelined(false);
+    Blitter::shutdown();
+
+    loader.stop();
+    TextureCache::setPrefetcher(NULL);
+
+    TextureCache::report();
+    loader.report();
+    pacer.report();
+    FontManager::shutdown();
+
     return 0;
 }
 
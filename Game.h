@@ -20,6 +20,8 @@
 #include "StateEngine.h"
 #include "ControlEngine.h"
 #include "AudioEngine.h"
+#include "FramePacer.h"
+#include "Prefetcher.h"
 
 class Game
 {
@@ -31,7 +33,10 @@ class Game
         MechanicsEngine mech;
         ControlEngine   control;
         AudioEngine     audi;
+        FramePacer      pacer;
+        Prefetcher      loader;
         bool            running;
+        int             tickRate;
 
     public:
         Game();
@@ -39,6 +44,11 @@ class Game
         void    init();
         int     run();
 
+        void    setTickRate(int hz);
+        int     getTickRate() {return tickRate;}
+        void    setFrameRate(int hz) {pacer.setRate(hz);}
+        void    setLowPower(bool on) {pacer.setLowPower(on);}
+
 };
 
 #endif
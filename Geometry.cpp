@@ -13,34 +13,12 @@ Point::Point(int a, int b)
 /*******************************************************************************
  Vect methods
  ******************************************************************************/
-Vect::Vect(double a, double b) 
-{
-    x = a;
-    y = b;
-}
-
 Vect::Vect(Point a, Point b)
 {
     x = b.x - a.x;
     y = b.y - a.y;
 }
 
-Vect Vect::operator+(Vect v)
-{
-    Vect t(*this);
-    t.x += v.x;
-    t.y += v.y;
-    return t;
-}
-
-Vect Vect::operator*(double n)
-{
-    Vect t(*this);
-    t.x *= n;
-    t.y *= n;
-    return t;
-}
-
 double Vect::slope()
 {
     if(x) return y / x;
@@ -49,7 +27,7 @@ double Vect::slope()
 
 double Vect::len()
 {
-    return sqrt(pow(x, 2.0) + pow(y, 2.0));
+    return sqrt(x * x + y * y);
 }
 
 double Vect::angle()
@@ -400,16 +378,146 @@ bool doIntersect(SDL_Rect a, SDL_Rect b)
     return true;
 }
 
+/*******************************************************************************
+ Name:              unite
+ Description:       The smallest rectangle holding both; an empty rectangle
+                    adds nothing
+ ******************************************************************************/
+SDL_Rect unite(SDL_Rect a, SDL_Rect b)
+{
+    if(a.w == 0 || a.h == 0)    return b;
+    if(b.w == 0 || b.h == 0)    return a;
+
+    int left   = min((int)a.x, (int)b.x);
+    int top    = min((int)a.y, (int)b.y);
+    int right  = max(a.x + a.w, b.x + b.w);
+    int bottom = max(a.y + a.h, b.y + b.h);
+
+    SDL_Rect r;
+    r.x = left;
+    r.y = top;
+    r.w = right - left;
+    r.h = bottom - top;
+
+    return r;
+}
+
 bool doIntersect(Circle a, Circle b)
 {
-    int difX = a.cent.x - b.cent.x;
-    int difY = a.cent.y - b.cent.y;
-    int dist = sqrt(pow(difX, 2.0) + pow(difY, 2.0));
+    double difX = a.cent.x - b.cent.x;
+    double difY = a.cent.y - b.cent.y;
+    double r    = a.rad + b.rad;
     
-    if(dist <= a.rad + b.rad)
+    //compare squared lengths, no sqrt needed
+    return difX * difX + difY * difY <= r * r;
+}
+
+bool doIntersect(Circle a, SDL_Rect b)
+{
+    //distance from the center to the closest point of the box
+    double difX = 0, difY = 0;
+
+    if(a.cent.x < b.x)              difX = b.x - a.cent.x;
+    else if(a.cent.x > b.x + b.w)   difX = a.cent.x - (b.x + b.w);
+    if(a.cent.y < b.y)              difY = b.y - a.cent.y;
+    else if(a.cent.y > b.y + b.h)   difY = a.cent.y - (b.y + b.h);
+
+    return difX * difX + difY * difY <= a.rad * a.rad;
+}
+
+/*******************************************************************************
+ Name:              findContact
+ Description:       Finds the contact normal and penetration depth of two
+                    overlapping shapes using only dot products and one sqrt
+
+ Output:
+    c               The contact, normal pointing from a to b
+    returns         false if the shapes do not touch (c is left unset)
+ ******************************************************************************/
+bool findContact(Circle a, Circle b, Contact& c)
+{
+    Vect   d(a.cent, b.cent);
+    double r  = a.rad + b.rad;
+    double d2 = d.dot(d);
+
+    if(d2 > r * r)
+        return false;
+
+    double dist = sqrt(d2);
+
+    //concentric circles, push straight up
+    if(dist == 0)   c.normal = Vect(0, -1);
+    else            c.normal = d * (1 / dist);
+
+    c.depth = r - dist;
+    return true;
+}
+
+bool findContact(Circle a, SDL_Rect b, Contact& c)
+{
+    //clamp the center onto the box to find its closest point
+    double qx = a.cent.x, qy = a.cent.y;
+
+    if(qx < b.x)        qx = b.x;
+    if(qx > b.x + b.w)  qx = b.x + b.w;
+    if(qy < b.y)        qy = b.y;
+    if(qy > b.y + b.h)  qy = b.y + b.h;
+
+    Vect   d(qx - a.cent.x, qy - a.cent.y);
+    double d2 = d.dot(d);
+
+    if(d2 > a.rad * a.rad)
+        return false;
+
+    if(d2 > 0)
+    {
+        double dist = sqrt(d2);
+        c.normal = d * (1 / dist);
+        c.depth  = a.rad - dist;
         return true;
-    
-    return false;
+    }
+
+    //center is inside the box, leave through the nearest side
+    double toLeft   = a.cent.x - b.x;
+    double toRight  = b.x + b.w - a.cent.x;
+    double toTop    = a.cent.y - b.y;
+    double toBottom = b.y + b.h - a.cent.y;
+
+    double least = toLeft;
+    c.normal = Vect(1, 0);
+
+    if(toRight < least)     {least = toRight;  c.normal = Vect(-1, 0);}
+    if(toTop < least)       {least = toTop;    c.normal = Vect(0, 1);}
+    if(toBottom < least)    {least = toBottom; c.normal = Vect(0, -1);}
+
+    c.depth = a.rad + least;
+    return true;
+}
+
+bool findContact(SDL_Rect a, SDL_Rect b, Contact& c)
+{
+    //overlap on each axis, edges are inclusive as in doIntersect
+    int overX = min(a.x + a.w, b.x + b.w) - max((int)a.x, (int)b.x);
+    int overY = min(a.y + a.h, b.y + b.h) - max((int)a.y, (int)b.y);
+
+    if(overX < 0 || overY < 0)
+        return false;
+
+    //separate along the axis that overlaps least
+    if(overY <= overX)
+    {
+        if(a.y + a.h / 2 < b.y + b.h / 2)   c.normal = Vect(0, 1);
+        else                                c.normal = Vect(0, -1);
+        c.depth = overY;
+    }
+    else
+    {
+        if(a.x + a.w / 2 < b.x + b.w / 2)   c.normal = Vect(1, 0);
+        else                                c.normal = Vect(-1, 0);
+        c.depth = overX;
+    }
+
+    return true;
 }
 
 Point pointOfIntersection(Circle a, Circle b)
@@ -3,6 +3,7 @@
 
 #include <SDL/SDL.h>
 #include <cmath>
+#include <algorithm>
 
 using namespace std;
 
@@ -46,11 +47,13 @@ struct Vect
 {
     double x, y;
     
-    Vect(double a = 0, double b = 0);
+    Vect(double a = 0, double b = 0) {x = a; y = b;}
     Vect(Point a, Point b);
     
-    Vect    operator+(Vect v);
-    Vect    operator*(double n);
+    //inline, the contact solver calls these hundreds of times a tick
+    Vect    operator+(Vect v) {return Vect(x + v.x, y + v.y);}
+    Vect    operator*(double n) {return Vect(x * n, y * n);}
+    double  dot(Vect v) {return x * v.x + y * v.y;}
     double  slope();
     double  len();
     double  angle();
@@ -141,12 +144,26 @@ struct Rect
     SDL_Rect    sdlVer();
 };
 
+/*******************************************************************************
+ Contact
+ ******************************************************************************/
+struct Contact
+{
+    Vect    normal;     //unit vector pointing from the first shape to the second
+    double  depth;      //how far the shapes overlap along normal
+};
+
 /*******************************************************************************
  Functions
  ******************************************************************************/
 Point   operator+(const Point& p, const Vect& v);
 bool    doIntersect(SDL_Rect a, SDL_Rect b);
+SDL_Rect unite(SDL_Rect a, SDL_Rect b);
 bool    doIntersect(Circle a, Circle b);
+bool    doIntersect(Circle a, SDL_Rect b);
+bool    findContact(Circle a, Circle b, Contact& c);
+bool    findContact(Circle a, SDL_Rect b, Contact& c);
+bool    findContact(SDL_Rect a, SDL_Rect b, Contact& c);
 Point   pointOfIntersection(Circle a, Circle b);
 
 #endif
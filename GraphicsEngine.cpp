@@ -7,22 +7,105 @@
                             the screen.
  ******************************************************************************/
 
+#include <algorithm>
+
 #include "GraphicsEngine.h"
 #include "DrawableObject.h"
 #include "Room.h"
+#include "Geometry.h"
+#include "Blitter.h"
+
+const int SCREEN_W = 1280;
+const int SCREEN_H = 720;
+
+//above this share of the screen, drawing the whole frame is cheaper
+const double FULL_FRAME_SHARE = 0.5;
+
+/*******************************************************************************
+ Name:              scroll
+ Description:       How far into the background to start drawing, so a
+                    background bigger than the screen scrolls as far across
+                    itself as the view is across the field, and one the
+                    size of the screen stays put
+
+ Input:
+    at              Where the view starts in the field
+    view            Size of the view
+    bg              Size of the background
+    field           Size of the field
+ ******************************************************************************/
+static int scroll(int at, int view, int bg, int field)
+{
+    if(bg <= view || field <= view)
+        return 0;
+
+    return min(at * (bg - view) / (field - view), bg - view);
+}
+
+GraphicsEngine* GraphicsEngine::piped     = NULL;
+GraphicsEngine* GraphicsEngine::lastDrawn = NULL;
 
 /*******************************************************************************
  Name:              GraphicsEngine
- Description:       Default constructor for GraphicsEngine class
+ Description:       Default constructor for GraphicsEngine class. Drawing
+                    starts unpipelined.
+
+ Input:
+    threads         Threads to draw on
+    w, h            Size of the screen; 0 keeps the size already set, or
+                    SCREEN_W x SCREEN_H for the first engine
  ******************************************************************************/
-GraphicsEngine::GraphicsEngine()
+GraphicsEngine::GraphicsEngine(int threads, int w, int h)
+    :   pool(threads)
 {
-    screen = SDL_SetVideoMode(1280, 720, 32, SDL_SWSURFACE | SDL_DOUBLEBUF);
+    //another engine may still be drawing the screen this one takes over
+    if(piped)
+        piped->finish();
+
+    if(w <= 0 || h <= 0)
+    {
+        SDL_Surface* current = SDL_GetVideoSurface();
+
+        w = current ? current->w : SCREEN_W;
+        h = current ? current->h : SCREEN_H;
+    }
+
+    screen = SDL_SetVideoMode(w, h, 32, SDL_SWSURFACE | SDL_DOUBLEBUF);
 
     if(!screen)
     {
         exit(-1);
     }
+
+    Blitter::init();
+
+    SDL_Rect all;
+    all.x = 0;
+    all.y = 0;
+    all.w = screen->w;
+    all.h = screen->h;
+    whole.push_back(all);
+
+    pipelined      = false;
+    renderer       = NULL;
+    ready          = SDL_CreateSemaphore(0);
+    idle           = SDL_CreateSemaphore(1);
+    quit           = false;
+    front          = &lists[0];
+    back           = &lists[1];
+    numDropped     = 0;
+
+    dirtyRects     = true;
+    lastRoom       = NULL;
+    lastBackground = NULL;
+    lastView       = whole[0];
+    toPresent      = false;
+    presentFull    = false;
+    drewStill      = false;
+    still          = false;
+    numFull        = 0;
+    numPartial     = 0;
+    frame          = 0;
 }
 
 /*******************************************************************************
@@ -31,47 +114,426 @@ GraphicsEngine::GraphicsEngine()
  ******************************************************************************/
 GraphicsEngine::~GraphicsEngine()
 {
+    setPipelined(false);
+
+    if(lastDrawn == this)
+        lastDrawn = NULL;
+
+    SDL_DestroySemaphore(ready);
+    SDL_DestroySemaphore(idle);
     SDL_FreeSurface(screen);
 }
 
+/*******************************************************************************
+ Name:              setPipelined
+ Description:       Starts or stops the render thread. Only one engine at a
+                    time may have one.
+ ******************************************************************************/
+void GraphicsEngine::setPipelined(bool on)
+{
+    if(on == pipelined)
+        return;
+
+    if(on)
+    {
+        if(piped)
+            piped->setPipelined(false);
+
+        pipelined = true;
+        piped     = this;
+        renderer  = SDL_CreateThread(renderMain, this);
+    }
+    else
+    {
+        finish();
+
+        quit = true;
+        SDL_SemPost(ready);
+        SDL_WaitThread(renderer, NULL);
+
+        quit      = false;
+        renderer  = NULL;
+        pipelined = false;
+        piped     = NULL;
+    }
+}
+
+/*******************************************************************************
+ Name:              finish
+ Description:       Waits for the render thread to draw the frame it has and
+                    presents it. Call before anything else touches the
+                    screen.
+ ******************************************************************************/
+void GraphicsEngine::finish()
+{
+    if(!pipelined)
+        return;
+
+    SDL_SemWait(idle);
+    present();
+    SDL_SemPost(idle);
+}
+
+/*******************************************************************************
+ Name:              setDirtyRects
+ Description:       Turns dirty rectangle mode on or off. Either way the next
+                    frame is drawn whole.
+ ******************************************************************************/
+void GraphicsEngine::setDirtyRects(bool on)
+{
+    finish();
+
+    dirtyRects = on;
+    lastRoom   = NULL;
+}
+
 /*******************************************************************************
  Name:              run
- Description:       This method updates the screen
+ Description:       This method updates the screen. Physical objects are
+                    drawn between their last two physics ticks. When
+                    pipelined, the frame is drawn on the render thread and
+                    shown at the next call.
+
+ Input:
+    alpha           How far the simulation is into the next tick, 0 to 1
  ******************************************************************************/
-void GraphicsEngine::run(Room& room)
+void GraphicsEngine::run(Room& room, double alpha)
 {
-    vector<DrawableObject*> temp;
-    for(int i = 0; i < room.getNumObjects(); i++)
+    record(room, alpha, *back);
+
+    if(!pipelined)
     {
-        Object* obj = room.getObjectAt(i);
+        swap(front, back);
+        handOver();
+        render(*front);
+        present();
+        still = drewStill;
+        return;
+    }
 
-        if(obj->isDrawable() && obj->getActiveDraw())
-            temp.push_back(dynamic_cast<DrawableObject*>(obj));
+    //still drawing the last frame, this one is dropped; the objects keep
+    //their changed flags for the next
+    if(SDL_SemTryWait(idle) != 0)
+    {
+        numDropped++;
+        return;
     }
 
-    sortByLayer(temp);
+    present();
+    still = drewStill;
+
+    swap(front, back);
+    handOver();
+    SDL_SemPost(ready);
+}
+
+/*******************************************************************************
+ Name:              record
+ Description:       Writes down a frame as the camera sees it: for each
+                    object in view in layer order, at its interpolated
+                    position, its Handle, bounds and blits, moved onto the
+                    screen unless the object is fixed there
+
+ Output:
+    list            The frame
+ ******************************************************************************/
+void GraphicsEngine::record(Room& room, double alpha, DrawList& list)
+{
+    World&       world = room.getWorld();
+    Camera&      cam   = room.getCamera();
+    SDL_Surface* bg    = room.getBackground();
+
+    cam.setViewSize(screen->w, screen->h);
 
+    SDL_Rect view = cam.show(alpha);
 
-    for(int i = 0; i < temp.size(); i++)
+    //only what the camera can see
+    room.getRenderQueue().query(view, world.fieldW, world.fieldH, queued);
+
+    list.clear();
+    list.setRoom(&room, bg);
+    list.view = view;
+
+    if(bg)
     {
-        temp[i]->draw(screen);
+        list.bgX = scroll(view.x, view.w, bg->w, world.fieldW);
+        list.bgY = scroll(view.y, view.h, bg->h, world.fieldH);
     }
 
-    SDL_Flip(screen);
-    SDL_BlitSurface(room.getBackground(), NULL, screen, NULL);
+    SDL_Surface* recorder = Blitter::startRecording(&list);
+
+    for(int i = 0; i < (int)queued.size(); i++)
+    {
+        DrawableObject* obj  = queued[i].obj;
+        PhysicalObject* body = queued[i].body;
+        SDL_Rect        real;
+        int             dx   = obj->isFixed() ? 0 : -view.x;
+        int             dy   = obj->isFixed() ? 0 : -view.y;
+
+        //draw at the interpolated position, then put the real one back
+        if(body)
+        {
+            real = body->getPos();
+            body->setPos(body->lerpPos(alpha));
+        }
+
+        obj->prepare();
+
+        DrawItem item;
+        item.handle  = obj->getHandle();
+        item.bounds  = obj->getBounds();
+        item.changed = obj->isChanged();
+        item.first   = (int)list.commands.size();
+        item.count   = 0;
+        item.bounds.x += dx;
+        item.bounds.y += dy;
+        list.items.push_back(item);
+
+        list.setOffset(dx, dy);
+        obj->draw(recorder);
+
+        if(body)
+            body->setPos(real);
+    }
+
+    Blitter::stopRecording();
 }
 
-void GraphicsEngine::sortByLayer(vector<DrawableObject*>& list)
+/*******************************************************************************
+ Name:              handOver
+ Description:       The front list is going to be drawn, so its objects'
+                    changes are accounted for
+ ******************************************************************************/
+void GraphicsEngine::handOver()
 {
-    for(int i = 0; i < list.size(); i++)
+    for(int i = 0; i < (int)queued.size(); i++)
+        queued[i].obj->clearChanged();
+}
+
+/*******************************************************************************
+ Name:              renderMain
+ Description:       The render thread: draws each list handed over until
+                    told to quit
+ ******************************************************************************/
+int GraphicsEngine::renderMain(void* data)
+{
+    GraphicsEngine* engine = (GraphicsEngine*)data;
+
+    while(true)
+    {
+        SDL_SemWait(engine->ready);
+
+        if(engine->quit)
+            break;
+
+        engine->render(*engine->front);
+        SDL_SemPost(engine->idle);
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+ Name:              render
+ Description:       Draws a frame onto the screen, whole or only what changed
+                    since the last one drawn, for present() to show
+
+ Input:
+    list            The frame
+ ******************************************************************************/
+void GraphicsEngine::render(DrawList& list)
+{
+    bool moved = list.view.x != lastView.x || list.view.y != lastView.y;
+    bool full  = !dirtyRects || lastDrawn != this || list.room != lastRoom ||
+                 list.background != lastBackground || moved;
+
+    //what moved, changed, came or went since the last frame
+    dirty.clear();
+    drawnNow.clear();
+    numMoved = 0;
+    frame++;
+
+    for(int i = 0; i < (int)list.items.size(); i++)
+        compare(list.items[i], full);
+
+    for(int i = 0; i < (int)drawnLast.size(); i++)
+    {
+        Shown& s = shown[drawnLast[i]];
+
+        if(s.frame == frame - 1)
+        {
+            if(!full)
+                markDirty(s.rect);
+            s.frame = -1;
+            numMoved++;
+        }
+    }
+
+    drawnLast.swap(drawnNow);
+
+    if(!full)
+    {
+        mergeDirty();
+
+        double area = 0;
+        for(int i = 0; i < (int)dirty.size(); i++)
+            area += (double)dirty[i].w * dirty[i].h;
+
+        if(area > FULL_FRAME_SHARE * screen->w * screen->h)
+            full = true;
+    }
+
+    if(full)
+    {
+        compositor.draw(screen, list, whole, pool);
+        numFull++;
+    }
+    else
+    {
+        if(!dirty.empty())
+            compositor.draw(screen, list, dirty, pool);
+        numPartial++;
+    }
+
+    drewStill      = numMoved == 0 && lastDrawn == this && !moved &&
+                     list.room == lastRoom && list.background == lastBackground;
+    toPresent      = true;
+    presentFull    = full;
+    lastDrawn      = this;
+    lastRoom       = list.room;
+    lastBackground = list.background;
+    lastView       = list.view;
+}
+
+/*******************************************************************************
+ Name:              present
+ Description:       Sends the last frame drawn to the display: the whole
+                    screen, or just its dirty rectangles
+ ******************************************************************************/
+void GraphicsEngine::present()
+{
+    if(!toPresent)
+        return;
+
+    if(presentFull)
+        SDL_Flip(screen);
+    else if(!dirty.empty())
+        SDL_UpdateRects(screen, (int)dirty.size(), &dirty[0]);
+
+    toPresent = false;
+}
+
+/*******************************************************************************
+ Name:              compare
+ Description:       Marks dirty where an object is drawn this frame if it is
+                    new, or where it was and is if it moved or changed, and
+                    remembers where it is. Counts it in numMoved if so, even
+                    when the whole frame is drawn.
+
+ Input:
+    item            The object
+    full            The whole frame is drawn, nothing needs marking
+ ******************************************************************************/
+void GraphicsEngine::compare(DrawItem& item, bool full)
+{
+    Handle   h = item.handle;
+    SDL_Rect b = item.bounds;
+
+    //not tracked, so always redrawn, but only counted when changed
+    if(h.isNull())
+    {
+        if(!full)
+            markDirty(b);
+        if(item.changed)
+            numMoved++;
+        return;
+    }
+
+    if(h.index >= (int)shown.size())
+    {
+        Shown none;
+        none.generation = 0;
+        none.frame      = -1;
+        shown.resize(h.index + 1, none);
+    }
+
+    Shown& s = shown[h.index];
+
+    bool fresh = s.frame != frame - 1;
+    bool moved = !fresh &&
+                 (s.generation != h.generation || item.changed ||
+                  s.rect.x != b.x || s.rect.y != b.y || s.rect.w != b.w || s.rect.h != b.h);
+
+    if(fresh || moved)
+        numMoved++;
+
+    if(!full)
     {
-        for(int j = 0; j < list.size() - 1; j++)
+        if(fresh)
+        {
+            markDirty(b);
+        }
+        else if(moved)
+        {
+            //a new object in a slot freed last frame also clears the old one
+            markDirty(s.rect);
+            markDirty(b);
+        }
+    }
+
+    s.generation = h.generation;
+    s.frame      = frame;
+    s.rect       = b;
+    drawnNow.push_back(h.index);
+}
+
+/*******************************************************************************
+ Name:              markDirty
+ Description:       Adds a rectangle to redraw, cut to the screen
+ ******************************************************************************/
+void GraphicsEngine::markDirty(SDL_Rect r)
+{
+    int left   = max((int)r.x, 0);
+    int top    = max((int)r.y, 0);
+    int right  = min(r.x + r.w, screen->w);
+    int bottom = min(r.y + r.h, screen->h);
+
+    if(right <= left || bottom <= top)
+        return;
+
+    r.x = left;
+    r.y = top;
+    r.w = right - left;
+    r.h = bottom - top;
+
+    dirty.push_back(r);
+}
+
+/*******************************************************************************
+ Name:              mergeDirty
+ Description:       Joins dirty rectangles that touch until none do, so no
+                    pixel is drawn twice
+ ******************************************************************************/
+void GraphicsEngine::mergeDirty()
+{
+    bool merged = true;
+
+    while(merged)
+    {
+        merged = false;
+
+        for(int i = 0; i < (int)dirty.size(); i++)
         {
-            if(list[j]->getLayer() >  list[j+1]->getLayer())
+            for(int j = i + 1; j < (int)dirty.size(); j++)
             {
-                DrawableObject* temp = list[j];
-                list[j] = list[j+1];
-                list[j+1] = temp;
+                if(doIntersect(dirty[i], dirty[j]))
+                {
+                    dirty[i] = unite(dirty[i], dirty[j]);
+                    dirty[j] = dirty.back();
+                    dirty.pop_back();
+                    merged = true;
+                    j = i;
+                }
             }
         }
     }
@@ -5,28 +5,155 @@
  Description:               This file declares the GraphicsEngine class. The
                             GraphicsEngine class is responsible for output to
                             the screen.
+
+                            In dirty rectangle mode (the default) only what
+                            changed since the last frame is redrawn: the old
+                            and new bounds of every object that moved,
+                            changed, came or went are merged into a few
+                            rectangles, the background is restored in those
+                            alone, the objects touching them are drawn
+                            clipped to them, and only they are sent to the
+                            display with SDL_UpdateRects. When they cover
+                            more than FULL_FRAME_SHARE of the screen, or the
+                            room or background changed, the whole frame is
+                            drawn and flipped instead.
+
+                            The objects to draw come from the Room's
+                            RenderQueue, already in layer order. Lists used
+                            every frame are members, so a frame allocates
+                            nothing once they have grown.
+
+                            Either way the Compositor does the drawing, tile
+                            by tile on a ThreadPool.
+
+                            A frame is drawn in three steps. run() records it
+                            on the game thread into a DrawList: positions
+                            interpolated, and every blit the objects' draw
+                            methods make written down. render() works out
+                            what to redraw from the list and draws it.
+                            present() sends it to the display. When
+                            pipelined, render() runs on a thread of its own
+                            while the game goes on to its next tick: run()
+                            records into the back list and, if the render
+                            thread is done with the front one, swaps them and
+                            hands it over; otherwise the frame is dropped and
+                            the next one is recorded fresh. The game thread
+                            never waits, and presents each frame at the hand
+                            off after it is drawn, so SDL's video calls stay
+                            on one thread.
+
+                            The screen shows the part of the room's field
+                            its Camera looks at. Objects are found through
+                            the RenderQueue's grid, so only those in view are
+                            recorded, and moved onto the screen unless fixed
+                            there; when the camera moves, the whole frame is
+                            drawn.
+
+                            isStill() tells the game whether the last frame
+                            drawn was the same as the one before, so it can
+                            slow down when nothing is happening.
  ******************************************************************************/
 
 #ifndef AngrySomething_GraphicsEngine_h
 #define AngrySomething_GraphicsEngine_h
 
+#include <vector>
 #include <SDL/SDL.h>
 #include "DrawableObject.h"
+#include "PhysicalObject.h"
 #include "Room.h"
+#include "Compositor.h"
+#include "DrawList.h"
+#include "ThreadPool.h"
 
 class Room;
 
+using namespace std;
+
+/*******************************************************************************
+ Struct Shown
+ Description:       Where an object was drawn, kept per World slot
+ ******************************************************************************/
+struct Shown
+{
+    int         generation;     //of the object in the slot when drawn
+    int         frame;          //when last drawn
+    SDL_Rect    rect;
+};
+
 class GraphicsEngine
 {
     private:
-        SDL_Surface*    screen;
+        SDL_Surface*            screen;
+        ThreadPool              pool;
+        Compositor              compositor;
+        vector<SDL_Rect>        whole;          //the screen, as one region
+
+        //the render thread, and the lists it takes turns drawing
+        bool                    pipelined;
+        SDL_Thread*             renderer;
+        SDL_sem*                ready;          //posted when front is handed over
+        SDL_sem*                idle;           //held while front is drawn
+        bool                    quit;
+        DrawList                lists[2];
+        DrawList*               front;          //drawn by render()
+        DrawList*               back;           //recorded by run()
+        vector<DrawEntry>       queued;         //this frame, lowest layer first
+        int                     numDropped;
+        bool                    still;          //drewStill, as of the last hand off
+
+        static GraphicsEngine*  piped;          //the engine with a render thread
+        static GraphicsEngine*  lastDrawn;      //the engine that drew the screen
+
+        //from here down, only render() and present() use these
+        bool                    dirtyRects;
+        vector<Shown>           shown;          //by Handle index
+        vector<int>             drawnLast;      //slots drawn last frame
+        vector<int>             drawnNow;
+        int                     frame;
+        Room*                   lastRoom;
+        SDL_Surface*            lastBackground;
+        SDL_Rect                lastView;
+        vector<SDL_Rect>        dirty;
+        bool                    toPresent;
+        bool                    presentFull;
+        int                     numMoved;       //objects that moved, came or went
+        bool                    drewStill;      //the last frame drawn was the one before
+        int                     numFull;
+        int                     numPartial;
+
+        static int      renderMain(void* data);
+
+        void            record(Room& room, double alpha, DrawList& list);
+        void            handOver();
+        void            render(DrawList& list);
+        void            present();
+        void            markDirty(SDL_Rect r);
+        void            mergeDirty();
+        void            compare(DrawItem& item, bool full);
+
+        GraphicsEngine(const GraphicsEngine&);
+        GraphicsEngine& operator=(const GraphicsEngine&);
 
     public:
-        GraphicsEngine();
+        GraphicsEngine(int threads = ThreadPool::numCores(), int w = 0, int h = 0);
         ~GraphicsEngine();
 
-        void            run(Room&);
-        void            sortByLayer(vector<DrawableObject*>&);
+        void            run(Room&, double alpha = 1);
+        void            finish();
+
+        void            setPipelined(bool on);
+        bool            getPipelined() {return pipelined;}
+        int             getNumDropped() {return numDropped;}
+        bool            isStill() {return still;}
+        void            setDirtyRects(bool on);
+        void            setNumThreads(int threads) {finish(); pool.setNumThreads(threads);}
+        int             getNumThreads() {return pool.getNumThreads();}
+        void            setTileSize(int w, int h) {finish(); compositor.setTileSize(w, h);}
+        bool            getDirtyRects() {return dirtyRects;}
+        int             getNumFullFrames() {return numFull;}
+        int             getNumPartialFrames() {return numPartial;}
+        SDL_Surface*    getScreen() {return screen;}
 };
 
 #endif
@@ -0,0 +1,33 @@
+/*******************************************************************************
+ Filename:                  Handle.h
+ Classname:                 Handle
+
+ Description:               This file declares the Handle struct. A Handle
+                            names an object in a World by the slot it holds
+                            in the World's table and the generation of that
+                            slot. When the object is destroyed the slot's
+                            generation goes up, so an old Handle looks up as
+                            NULL instead of pointing at freed memory or at
+                            whatever took the slot next. Keep a Handle,
+                            rather than a pointer, to any object you do not
+                            own.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Handle_h
+#define AngrySomething_Handle_h
+
+struct Handle
+{
+    int     index;          //slot in the World's table, -1 for none
+    int     generation;
+
+    Handle() : index(-1), generation(0) {}
+    Handle(int i, int g) : index(i), generation(g) {}
+
+    bool    isNull() const {return index < 0;}
+    bool    operator==(const Handle& h) const {return index == h.index && generation == h.generation;}
+    bool    operator!=(const Handle& h) const {return !(*this == h);}
+    bool    operator<(const Handle& h) const {return index < h.index || (index == h.index && generation < h.generation);}
+};
+
+#endif
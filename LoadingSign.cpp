@@ -0,0 +1,112 @@
+/*******************************************************************************
+ Filename:                  LoadingSign.cpp
+ Classname:                 LoadingSign
+
+ Description:               This file defines the LoadingSign class.
+ ******************************************************************************/
+
+#include <string>
+
+#include "LoadingSign.h"
+#include "TextCache.h"
+#include "Geometry.h"
+#include "World.h"
+
+using namespace std;
+
+const int    PHASES   = 4;      //no dots up to three
+const Uint32 PHASE_MS = 250;
+const int    BOB      = 4;      //px the bird rises each phase
+const int    GAP      = 10;     //px between the bird and the word
+
+/*******************************************************************************
+ Name:              LoadingSign
+ Description:       Constructor. The sign goes in the middle of the screen,
+                    over everything on it.
+ ******************************************************************************/
+LoadingSign::LoadingSign()
+    :   Object(0, 0),
+        DrawableObject("AngryBird.bmp", 5)
+{
+    shownPhase = -1;
+    activeDraw = true;
+    activePhys = false;
+    activeMech = false;
+    activeCont = false;
+    fixed      = true;
+
+    pos.w = frame.w;
+    pos.h = frame.h;
+    pos.x = World::FIELD_W / 2 - pos.w;
+    pos.y = World::FIELD_H / 2 - pos.h / 2;
+}
+
+int LoadingSign::phase()
+{
+    return (int)(SDL_GetTicks() / PHASE_MS % PHASES);
+}
+
+SDL_Rect LoadingSign::textLoc()
+{
+    SDL_Rect r;
+
+    r.x = pos.x + pos.w + GAP;
+    r.y = pos.y;
+    r.w = message ? message->w : 0;
+    r.h = message ? message->h : 0;
+
+    return r;
+}
+
+/*******************************************************************************
+ Name:              prepare
+ Description:       Moves the bird and renders the dots, once per phase
+ ******************************************************************************/
+void LoadingSign::prepare()
+{
+    int p = phase();
+
+    if(p == shownPhase)
+        return;
+
+    TextCache::release(message);
+    message    = TextCache::acquire(font, "Loading" + string(p, '.'), fontColor);
+    shownPhase = p;
+    changed    = true;
+}
+
+/*******************************************************************************
+ Name:              draw
+ Description:       Draws the Object to the given SDL_Surface*
+
+ Input:
+    s               SDL_Surface* to be drawn onto
+ ******************************************************************************/
+void LoadingSign::draw(SDL_Surface* s)
+{
+    SDL_Rect loc  = pos;
+    SDL_Rect text = textLoc();
+
+    loc.y -= shownPhase * BOB;
+
+    Blitter::blit(image, &frame, s, &loc);
+    Blitter::blit(message, NULL, s, &text);
+}
+
+/*******************************************************************************
+ Name:              getBounds
+ Description:       The bird at the top and bottom of its bob, and the word
+                    as it is now
+ ******************************************************************************/
+SDL_Rect LoadingSign::getBounds()
+{
+    SDL_Rect r = pos;
+
+    r.y -= (PHASES - 1) * BOB;
+    r.h += (PHASES - 1) * BOB;
+
+    if(message)
+        r = unite(r, textLoc());
+
+    return r;
+}
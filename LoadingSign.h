@@ -0,0 +1,38 @@
+/*******************************************************************************
+ Filename:                  LoadingSign.h
+ Classname:                 LoadingSign
+
+ Description:               This file declares the LoadingSign class. The
+                            StateEngine puts a LoadingSign over the screen a
+                            level was picked from while the Prefetcher is
+                            still decoding the level's images, so the wait
+                            does not look like a freeze. It is a bird that
+                            bobs in the middle of the screen, beside the word
+                            "Loading" and a row of dots that grows and starts
+                            over.
+ ******************************************************************************/
+
+#ifndef AngrySomething_LoadingSign_h
+#define AngrySomething_LoadingSign_h
+
+#include <SDL/SDL.h>
+
+#include "DrawableObject.h"
+
+class LoadingSign : public DrawableObject
+{
+    private:
+        int         shownPhase;     //of the bob and the dots, last drawn
+
+        int         phase();
+        SDL_Rect    textLoc();
+
+    public:
+        LoadingSign();
+
+        void        prepare();
+        void        draw(SDL_Surface*);
+        SDL_Rect    getBounds();
+};
+
+#endif
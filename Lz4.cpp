@@ -0,0 +1,266 @@
+/*******************************************************************************
+ Filename:                  Lz4.cpp
+ Classname:                 Lz4
+
+ Description:               This file defines the Lz4 class.
+ ******************************************************************************/
+
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "Lz4.h"
+
+using namespace std;
+
+const int MIN_MATCH     = 4;
+const int LAST_LITERALS = 5;        //the block always ends in literals
+const int MF_LIMIT      = 12;       //no match starts this close to the end
+const int MAX_OFFSET    = 65535;
+const int HASH_BITS     = 12;
+const int RUN_MASK      = 15;       //a 4 bit length of 15 carries on in bytes
+
+static unsigned int read32(const unsigned char* p)
+{
+    unsigned int v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static int hashOf(unsigned int v)
+{
+    return (int)((v * 2654435761U) >> (32 - HASH_BITS));
+}
+
+/*******************************************************************************
+ Name:              writeLength
+ Description:       Writes the part of a length past RUN_MASK as a run of 255s
+                    and a last byte
+
+ Output:
+    returns         false if it did not fit
+ ******************************************************************************/
+static bool writeLength(int n, unsigned char*& op, unsigned char* end)
+{
+    for(; n >= 255; n -= 255)
+    {
+        if(op >= end)
+            return false;
+        *op++ = 255;
+    }
+
+    if(op >= end)
+        return false;
+    *op++ = (unsigned char)n;
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              writeSequence
+ Description:       Writes a run of literals and, unless it ends the block,
+                    the match after it
+
+ Input:
+    lit, litLen     The literals
+    offset          How far back the match is, 0 for the last run
+    matchLen        Its length
+
+ Output:
+    returns         false if it did not fit
+ ******************************************************************************/
+static bool writeSequence(const unsigned char* lit, int litLen, int offset,
+                          int matchLen, unsigned char*& op, unsigned char* end)
+{
+    if(op >= end)
+        return false;
+
+    unsigned char* token = op++;
+
+    *token = (unsigned char)((litLen < RUN_MASK ? litLen : RUN_MASK) << 4);
+    if(litLen >= RUN_MASK && !writeLength(litLen - RUN_MASK, op, end))
+        return false;
+
+    if(end - op < litLen)
+        return false;
+    memcpy(op, lit, litLen);
+    op += litLen;
+
+    if(!offset)
+        return true;
+
+    if(end - op < 2)
+        return false;
+    *op++ = (unsigned char)(offset & 0xFF);
+    *op++ = (unsigned char)(offset >> 8);
+
+    int ml = matchLen - MIN_MATCH;
+
+    *token |= (unsigned char)(ml < RUN_MASK ? ml : RUN_MASK);
+    if(ml >= RUN_MASK && !writeLength(ml - RUN_MASK, op, end))
+        return false;
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              bound
+ Description:       The most compress() can write for size bytes, when
+                    nothing in them repeats
+ ******************************************************************************/
+int Lz4::bound(int size)
+{
+    return size + size / 255 + 16;
+}
+
+/*******************************************************************************
+ Name:              compress
+ Description:       Packs a block
+
+ Input:
+    src, size       The bytes to pack
+    capacity        Room at dst; bound(size) is always enough
+
+ Output:
+    dst             The block
+    returns         Its length, or -1 if it did not fit
+ ******************************************************************************/
+int Lz4::compress(const unsigned char* src, int size, unsigned char* dst, int capacity)
+{
+    unsigned char* op  = dst;
+    unsigned char* end = dst + capacity;
+    int            anchor = 0;
+
+    if(size > MF_LIMIT)
+    {
+        vector<int> table(1 << HASH_BITS, -1);
+        int         mfLimit    = size - MF_LIMIT;
+        int         matchLimit = size - LAST_LITERALS;
+        int         ip         = 0;
+
+        while(ip < mfLimit)
+        {
+            unsigned int seq = read32(src + ip);
+            int          h   = hashOf(seq);
+            int          ref = table[h];
+
+            table[h] = ip;
+
+            if(ref < 0 || ip - ref > MAX_OFFSET || read32(src + ref) != seq)
+            {
+                ip++;
+                continue;
+            }
+
+            int len = MIN_MATCH;
+            while(ip + len < matchLimit && src[ref + len] == src[ip + len])
+                len++;
+
+            if(!writeSequence(src + anchor, ip - anchor, ip - ref, len, op, end))
+                return -1;
+
+            ip    += len;
+            anchor = ip;
+
+            //so the next match can start inside this one
+            if(ip - 2 < mfLimit)
+                table[hashOf(read32(src + ip - 2))] = ip - 2;
+        }
+    }
+
+    if(!writeSequence(src + anchor, size - anchor, 0, 0, op, end))
+        return -1;
+
+    return (int)(op - dst);
+}
+
+/*******************************************************************************
+ Name:              decompress
+ Description:       Unpacks a block, checking it as it goes
+
+ Input:
+    src, size       The block
+    capacity        Room at dst
+
+ Output:
+    dst             The bytes
+    returns         How many, or -1 if the block is damaged or would not fit
+ ******************************************************************************/
+int Lz4::decompress(const unsigned char* src, int size, unsigned char* dst, int capacity)
+{
+    int ip = 0;
+    int op = 0;
+
+    while(true)
+    {
+        if(ip >= size)
+            return -1;
+
+        int token = src[ip++];
+        int lit   = token >> 4;
+
+        if(lit == RUN_MASK)
+        {
+            int b;
+            do
+            {
+                if(ip >= size || lit > capacity)
+                    return -1;
+                b = src[ip++];
+                lit += b;
+            } while(b == 255);
+        }
+
+        if(lit > size - ip || lit > capacity - op)
+            return -1;
+
+        memcpy(dst + op, src + ip, lit);
+        ip += lit;
+        op += lit;
+
+        //the last run has no match after it
+        if(ip == size)
+            return op;
+
+        if(size - ip < 2)
+            return -1;
+
+        int offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+
+        if(offset == 0 || offset > op)
+            return -1;
+
+        int len = token & RUN_MASK;
+
+        if(len == RUN_MASK)
+        {
+            int b;
+            do
+            {
+                if(ip >= size || len > capacity)
+                    return -1;
+                b = src[ip++];
+                len += b;
+            } while(b == 255);
+        }
+        len += MIN_MATCH;
+
+        if(len > capacity - op)
+            return -1;
+
+        unsigned char* d = dst + op;
+        unsigned char* s = d - offset;
+
+        //a match may overlap what it is copying, repeating the last offset
+        //bytes; copy them in chunks that double, each from the start
+        for(int done = 0; done < len; )
+        {
+            int n = min(offset + done, len - done);
+            memcpy(d + done, s, n);
+            done += n;
+        }
+
+        op += len;
+    }
+}
@@ -0,0 +1,32 @@
+/*******************************************************************************
+ Filename:                  Lz4.h
+ Classname:                 Lz4
+
+ Description:               This file declares the Lz4 class. Lz4 packs and
+                            unpacks blocks in the LZ4 block format: runs of
+                            literal bytes, each followed by a copy of earlier
+                            output, with no entropy coding, so unpacking is
+                            little more than memcpy. The compressor is the
+                            simple greedy one, with a hash table of the last
+                            place each four bytes were seen; the game only
+                            compresses at build time, by tools/PackAssets.cpp.
+
+                            decompress() checks every length against both
+                            buffers, so a damaged archive fails to load rather
+                            than writing past the end of a surface.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Lz4_h
+#define AngrySomething_Lz4_h
+
+class Lz4
+{
+    public:
+        static int  bound(int size);
+        static int  compress(const unsigned char* src, int size,
+                             unsigned char* dst, int capacity);
+        static int  decompress(const unsigned char* src, int size,
+                               unsigned char* dst, int capacity);
+};
+
+#endif
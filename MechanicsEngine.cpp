@@ -8,19 +8,19 @@
 void MechanicsEngine::run(Room& room)
 {
     int state = 0;
-    Object* obj;
     Object* objTemp = NULL;
+    vector<MechanicsObject*>& mech = room.getMechanics();
 
-    for(int i = 0; i < room.getNumObjects() && !state; i++)
+    //objects added here are processed this tick too
+    for(int i = 0; i < (int)mech.size() && !state; i++)
     {
-        obj = room.getObjectAt(i);
-
-        if(obj->isMechanical() && obj->getActiveMech())
+        if(mech[i]->getActiveMech())
         {
-            objTemp = dynamic_cast<MechanicsObject*>(obj)->process();
+            objTemp = mech[i]->process();
             if(objTemp)
             {
-                room.add(objTemp);
+                Handle h = room.add(objTemp);
+                mech[i]->adopt(h);
             }
         }
     }
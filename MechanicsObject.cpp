@@ -1,28 +1,46 @@
 #include "MechanicsObject.h"
-
-int MechanicsObject::score = 0;
+#include "World.h"
 
 MechanicsObject::MechanicsObject()
 {
     mechanical  = true;
 }
 
+/*******************************************************************************
+ Name:              process
+ Description:       Runs the object's game logic once per tick
+
+ Output:
+    returns         A new object for the room to take, or NULL
+ ******************************************************************************/
 Object* MechanicsObject::process()
 {
     return NULL;
 }
 
-int MechanicsObject::getScore()
+/*******************************************************************************
+ Name:              adopt
+ Description:       Called with the Handle the room gave the object process()
+                    returned, for objects that keep track of what they made
+
+ Input:
+    h               Handle of the new object
+ ******************************************************************************/
+void MechanicsObject::adopt(Handle h)
 {
-    return score;
 }
 
-void MechanicsObject::adjustScore(int x)
+/*******************************************************************************
+ Name:              getScore, adjustScore
+ Description:       The score belongs to the world the object is in
+ ******************************************************************************/
+int MechanicsObject::getScore()
 {
-    score += x;
+    return world ? world->score : 0;
 }
 
-void MechanicsObject::resetScore()
+void MechanicsObject::adjustScore(int x)
 {
-    score = 0;
+    if(world)
+        world->score += x;
 }
\ No newline at end of file
@@ -8,16 +8,13 @@
 
 class MechanicsObject : virtual public Object
 {
-    private:
-        static int score;
-    
     public:
         MechanicsObject();
         virtual Object* process();
+        virtual void    adopt(Handle h);
     
         int getScore();
         void adjustScore(int);
-        static void resetScore();
 };
 
 #endif
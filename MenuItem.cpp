@@ -11,6 +11,7 @@ MenuItem::MenuItem(const char* file, int x, int y, int w, int h, int v)
     activePhys = false;
     activeMech = false;
     activeCont = false;
+    fixed = true;
 }
 
 MenuItem::~MenuItem()
@@ -70,10 +71,9 @@ int MenuItem::check()
  ******************************************************************************/
 void MenuItem::draw(SDL_Surface* s)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect loc = pos;
 
-    SDL_BlitSurface(image, NULL, s, &loc);
+    Blitter::blit(image, &frame, s, &loc);
 }
 
 void MenuItem::pause()
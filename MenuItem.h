@@ -21,6 +21,7 @@ class MenuItem : public DrawableObject, public ControllableObject, public Mechan
         ~MenuItem();
 
         void        draw(SDL_Surface*);
+        SDL_Rect    getBounds() {return imageBounds();}
         int         check();
         void        handle(SDL_Event);
         void        pause();
@@ -25,10 +25,9 @@ NonInteractionObject::~NonInteractionObject()
  ******************************************************************************/
 void NonInteractionObject::draw(SDL_Surface* s)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect loc = pos;
 
-    SDL_BlitSurface(image, NULL, s, &loc);
+    Blitter::blit(image, &frame, s, &loc);
 }
 
 void NonInteractionObject::pause()
@@ -19,6 +19,7 @@ class NonInteractionObject : public DrawableObject
         ~NonInteractionObject();
 
         void        draw(SDL_Surface*);
+        SDL_Rect    getBounds() {return imageBounds();}
         void        pause();
         void        unpause();
 };
@@ -7,6 +7,10 @@
 
 #include "Object.h"
 
+//set for simulations without a screen or sound: no images, fonts or sounds
+//are loaded, so nothing may be drawn or played
+bool Object::headless = false;
+
 /*******************************************************************************
  Name:              Object
  Description:       Default constructor for Object class
@@ -20,9 +24,11 @@ Object::Object(int x, int y, int w, int h)
     pos.h = h;
 
     drawable = physical = mechanical = controllable = audible = false;
+    fixed = false;
 
     state = 0;
     type = 0;
+    world = NULL;
 }
 
 Object::~Object()
@@ -30,6 +36,20 @@ Object::~Object()
 
 }
 
+/*******************************************************************************
+ Name:              setWorld
+ Description:       Called by Room::add. Objects that count towards the state
+                    of their world (pigs, birds, slings, bodies) override
+                    this to move their share from the old world to the new.
+
+ Input:
+    w               The World of the Room, or NULL
+ ******************************************************************************/
+void Object::setWorld(World* w)
+{
+    world = w;
+}
+
 /*******************************************************************************
  MUTATORS
  Name:              setType, setPos
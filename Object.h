@@ -10,6 +10,10 @@
 
 #include <SDL/SDL.h>
 
+#include "Handle.h"
+
+struct World;
+
 class Object
 {
     protected:
@@ -24,7 +28,13 @@ class Object
         bool        activePhys;
         bool        activeMech;
         bool        activeCont;
+        bool        fixed;  //on the screen, not in the field: drawn and
+                            //clicked where it is wherever the camera is
         int         type;   //1 = level, 2 = Utility
+        World*      world;  //set by the Room the object is added to
+        Handle      handle; //this object's Handle in that world
+
+        static bool headless;
 
     public:
         Object(int x = 0, int y = 0, int w = 0, int h = 0);
@@ -47,6 +57,7 @@ class Object
         bool            getActivePhys() {return activePhys;}
         bool            getActiveMech() {return activeMech;}
         bool            getActiveCont() {return activeCont;}
+        bool            isFixed() {return fixed;}
 //        void            setActiveDraw(bool b) {activeDraw = b;}
 //        void            setActivePhys(bool b) {activePhys = b;}
 //        void            setActiveMech(bool b) {activeMech = b;}
@@ -55,6 +66,14 @@ class Object
         virtual void    unpause();
 
         virtual void    run();
+
+        World*          getWorld() {return world;}
+        virtual void    setWorld(World* w);
+        Handle          getHandle() {return handle;}
+        void            setHandle(Handle h) {handle = h;}
+
+        static void     setHeadless(bool h) {headless = h;}
+        static bool     isHeadless() {return headless;}
 };
 
 #endif
@@ -14,6 +14,7 @@ PauseButton::PauseButton(const char* file, int x, int y, int w, int h)
     activePhys = false;
     activeMech = true;
     activeCont = true;
+    fixed = true;
 }
 
 PauseButton::~PauseButton()
@@ -62,34 +63,37 @@ void PauseButton::handle(SDL_Event e)
                     if(SDL_PollEvent(&event))
                     {
                         if( event.type == SDL_QUIT )
-                        {
-                            exit(0);
+                        {   //Exit the program, through the game loop
+                            MenuOpen = false;
+                            Value = -1;
+                            clicked = true;
+                            break;
                         }
                         for(int i = 0; i < 4; i++)
                         {
-                            dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->handle(event);
-                            if(dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->check() == 4)
+                            temp.getControllables()[i]->handle(event);
+                            if(temp.getControllables()[i]->check() == 4)
                             {   //Continue Running
                                 MenuOpen = false;
                                 Value = 0;
                                 clicked = true;
                             }
-                            dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->handle(event);
-                            if(dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->check() == 1)
+                            temp.getControllables()[i]->handle(event);
+                            if(temp.getControllables()[i]->check() == 1)
                             {   //Continue Running
                                 MenuOpen = false;
                                 Value = 0;
                                 clicked = true;
                             }
-                            dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->handle(event);
-                            if(dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->check() == 2)
+                            temp.getControllables()[i]->handle(event);
+                            if(temp.getControllables()[i]->check() == 2)
                             {   //Restart the level
                                 MenuOpen = false;
                                 Value = -5;
                                 clicked = true;
                             }
-                            dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->handle(event);
-                            if(dynamic_cast<ControllableObject*>(temp.getObjectAt(i))->check() == 3)
+                            temp.getControllables()[i]->handle(event);
+                            if(temp.getControllables()[i]->check() == 3)
                             {   //Exit to title screen
                                 MenuOpen = false;
                                 Value = -3;
@@ -125,10 +129,9 @@ int PauseButton::check()
  ******************************************************************************/
 void PauseButton::draw(SDL_Surface* s)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect loc = pos;
 
-    SDL_BlitSurface(image, NULL, s, &loc);
+    Blitter::blit(image, &frame, s, &loc);
 }
 
 void PauseButton::pause()
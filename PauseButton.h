@@ -28,6 +28,7 @@ class PauseButton : public DrawableObject, public MechanicsObject, public Contro
         ~PauseButton();
 
         void        draw(SDL_Surface*);
+        SDL_Rect    getBounds() {return imageBounds();}
         int         check();
         void        handle(SDL_Event);
         void        pause();
@@ -7,8 +7,7 @@
 
 #include "PhysicalObject.h"
 
-const double GRAV       = .3;
-const double TERM_VEL   = 20;
+const double SLEEP_VEL  = 1;
 
 /*******************************************************************************
  PhysicalObject()
@@ -17,17 +16,80 @@ PhysicalObject::PhysicalObject(int vx, int vy)
 {
     physical = true;
 
-    vel.x = vx;
-    vel.y = vy;
+    store        = NULL;
+    body         = -1;
+    detachedVel  = Vect(vx, vy);
+    detachedAcc  = Vect(0, GRAV);   //as BodyStore::add starts a body
+    detachedMass = 1600;
 
-    acc.x = 0;
-    acc.y = GRAV;     //gravity
+    shape = BOX;
 
-    mass = 1600;
+    asleep    = false;
+    restTicks = 0;
+    island    = -1;
 
-    collisionSide = NO_COLLISION;
+    prevPos = pos;
+}
 
-    shape = BOX;
+PhysicalObject::PhysicalObject(const PhysicalObject& other)
+    :   Object(other)
+{
+    //the copy is in no world until it is added to a Room
+    world        = NULL;
+    store        = NULL;
+    body         = -1;
+    detachedVel  = other.store ? other.store->getVel(other.body) : other.detachedVel;
+    detachedAcc  = other.store ? other.store->getAcc(other.body) : other.detachedAcc;
+    detachedMass = other.store ? other.store->getMass(other.body) : other.detachedMass;
+
+    shape = other.shape;
+
+    asleep    = false;
+    restTicks = 0;
+    island    = -1;
+
+    prevPos = pos;
+}
+
+PhysicalObject::~PhysicalObject()
+{
+    if(store)
+        store->remove(body);
+}
+
+/*******************************************************************************
+ Name:              setWorld
+ Description:       Moves the motion state into a slot of the new world's
+                    BodyStore, out of the old one's
+
+ Input:
+    w               The World of the Room, or NULL
+ ******************************************************************************/
+void PhysicalObject::setWorld(World* w)
+{
+    BodyStore* next = w ? &w->bodies : NULL;
+
+    if(next != store)
+    {
+        if(store)
+        {
+            detachedVel  = store->getVel(body);
+            detachedAcc  = store->getAcc(body);
+            detachedMass = store->getMass(body);
+            store->remove(body);
+            body = -1;
+        }
+
+        if(next)
+        {
+            body = next->add(detachedVel.x, detachedVel.y, detachedMass);
+            next->setAcc(body, detachedAcc);
+        }
+
+        store = next;
+    }
+
+    Object::setWorld(w);
 }
 
 /*******************************************************************************
@@ -35,18 +97,27 @@ PhysicalObject::PhysicalObject(int vx, int vy)
  ******************************************************************************/
 void PhysicalObject::setVel(Vect v)
 {
-    vel = v;
+    if(store)   store->setVel(body, v);
+    else        detachedVel = v;
+    wake();
 }
 
 void PhysicalObject::setAcc(Vect a)
 {
-    acc = a;
+    if(store)   store->setAcc(body, a);
+    else        detachedAcc = a;
+}
+
+void PhysicalObject::addAcc(double x, double y)
+{
+    if(store)   store->addAcc(body, x, y);
+    else        detachedAcc = detachedAcc + Vect(x, y);
 }
 
 void PhysicalObject::setCollisionSide(int s)
 {
-    if(s == BOTTOM)
-       collisionSide = s;
+    if(s == BOTTOM && store)
+       store->setFlag(body, BODY_GROUNDED, true);
 }
 
 /*******************************************************************************
@@ -54,22 +125,24 @@ void PhysicalObject::setCollisionSide(int s)
  ******************************************************************************/
 Vect PhysicalObject::getVel()
 {
-    return vel;
+    return store ? store->getVel(body) : detachedVel;
 }
 
 Vect PhysicalObject::getAcc()
 {
-    return acc;
+    return store ? store->getAcc(body) : detachedAcc;
 }
 
 int PhysicalObject::getMass()
 {
-    return mass;
+    return store ? store->getMass(body) : detachedMass;
 }
 
 int PhysicalObject::getCollisionSide()
 {
-    return collisionSide;
+    if(store && store->hasFlag(body, BODY_GROUNDED))
+        return BOTTOM;
+    return NO_COLLISION;
 }
 
 int PhysicalObject::getShape()
@@ -78,37 +151,111 @@ int PhysicalObject::getShape()
 }
 
 /*******************************************************************************
- move()
+ Name:              syncActive
+ Description:       Tells the BodyStore whether this body takes part in the
+                    next integrate(): it must be unpaused and awake.
  ******************************************************************************/
-void PhysicalObject::move()
+void PhysicalObject::syncActive()
+{
+    if(store)
+        store->setFlag(body, BODY_ACTIVE, activePhys && !asleep);
+}
+
+/*******************************************************************************
+ Name:              lerpPos
+ Description:       Position between the last two physics ticks, used to draw
+                    the object when rendering runs between ticks
+
+ Input:
+    alpha           0 gives the previous tick, 1 the current one
+ ******************************************************************************/
+SDL_Rect PhysicalObject::lerpPos(double alpha)
 {
-    vel.x += acc.x;
-    vel.y += acc.y;
+    SDL_Rect p = pos;
+    p.x = (Sint16)round(prevPos.x + (pos.x - prevPos.x) * alpha);
+    p.y = (Sint16)round(prevPos.y + (pos.y - prevPos.y) * alpha);
+    return p;
+}
 
-    //terminal velocities
-    if(vel.y > TERM_VEL)  vel.y = TERM_VEL;
-    if(vel.y < -TERM_VEL) vel.y = -TERM_VEL;
-    if(vel.x > TERM_VEL)  vel.x = TERM_VEL;
-    if(vel.x < -TERM_VEL) vel.x = -TERM_VEL;
+/*******************************************************************************
+ SLEEPING
+ Name:              updateRest, sleep, wake
+ Description:       A body that has stayed slower than SLEEP_VEL is counted as
+                    resting. The PhysicsEngine puts whole islands of resting
+                    bodies to sleep and skips them until something wakes them.
+ ******************************************************************************/
+void PhysicalObject::updateRest()
+{
+    if(getVel().len() < SLEEP_VEL)  restTicks++;
+    else                            restTicks = 0;
+}
 
-    if(abs(vel.x) < .3) vel.x = 0;
-    if(abs(vel.y) < 1.5 && collisionSide == BOTTOM) vel.y = 0;
+void PhysicalObject::sleep(int i)
+{
+    asleep = true;
+    island = i;
+    if(store)
+        store->setVel(body, Vect(0, 0));
+}
+
+void PhysicalObject::wake()
+{
+    asleep    = false;
+    restTicks = 0;
+    island    = -1;
+}
+
+/*******************************************************************************
+ Name:              move
+ Description:       Integrates just this body for one tick and moves it. The
+                    PhysicsEngine integrates all bodies at once through
+                    BodyStore::integrate() and then calls step() on each.
+ ******************************************************************************/
+void PhysicalObject::move()
+{
+    if(!store)
+        return;
 
-    acc.x = 0;
-    acc.y = GRAV;
+    store->setFlag(body, BODY_ACTIVE, true);
+    store->integrate(body);
+    step();
+}
 
-    pos.x += round(vel.x);
-    pos.y += round(vel.y);
+/*******************************************************************************
+ Name:              step
+ Description:       Moves the object by the whole-pixel step the BodyStore
+                    computed for it in the last integrate
+ ******************************************************************************/
+void PhysicalObject::step()
+{
+    if(!store)
+        return;
 
-    collisionSide = NO_COLLISION;
+    pos.x += store->getStepX(body);
+    pos.y += store->getStepY(body);
 }
 
 /*******************************************************************************
- run()
+ Name:              run
+ Description:       Per-tick behaviour after the body has been moved; nothing
+                    for a plain PhysicalObject
  ******************************************************************************/
 void PhysicalObject::run()
 {
-    move();
+
+}
+
+/*******************************************************************************
+ Name:              impact
+ Description:       Called by the ContactSolver when something hits this
+                    object; nothing happens to a plain PhysicalObject
+
+ Input:
+    v               Velocity of the hit relative to this object
+ ******************************************************************************/
+void PhysicalObject::impact(Vect v)
+{
+
 }
 
 /*******************************************************************************
@@ -116,21 +263,21 @@ void PhysicalObject::run()
  ******************************************************************************/
 void PhysicalObject::applyForce(int m, Vect v, int dir)
 {
+    Vect vel  = getVel();
+    int  mass = getMass();
+
     if(dir == 0)
     {
         v.y = vel.y * .8;   //friction
-        acc.x += ((m * (v.x - vel.x)) / mass) * .8;
-        acc.y += (v.y - vel.y) * .8;
+        addAcc(((m * (v.x - vel.x)) / mass) * .8, (v.y - vel.y) * .8);
     }
     else if(dir == 1)
     {
         v.x = vel.x * .8;   //friction
-        acc.x += (v.x - vel.x) * .8;
-        acc.y += ((m * (v.y - vel.y)) / mass) * .8;
+        addAcc((v.x - vel.x) * .8, ((m * (v.y - vel.y)) / mass) * .8);
     }
     else
     {
-        acc.x += ((m * (v.x - vel.x)) / mass) * .8;
-        acc.y += ((m * (v.y - vel.y)) / mass) * .8;
+        addAcc(((m * (v.x - vel.x)) / mass) * .8, ((m * (v.y - vel.y)) / mass) * .8);
     }
 }
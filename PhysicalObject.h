@@ -2,7 +2,11 @@
  Filename:                  PhysicalObject.h
  Classname:                 PhysicalObject
  
- Description:               This file declares the PhysicalObject class.
+ Description:               This file declares the PhysicalObject class. A
+                            PhysicalObject keeps its motion state in a slot of
+                            the BodyStore of the World it is in; the accessors
+                            here read and write that slot. Until it is added
+                            to a Room the state is kept in the object.
  ******************************************************************************/
 
 #ifndef PhysicalObject_H
@@ -11,21 +15,33 @@
 
 #include "Object.h"
 #include "Geometry.h"
+#include "BodyStore.h"
+#include "World.h"
 
 class PhysicalObject : virtual public Object
 {
     protected:
-        Vect    vel;
-        Vect    acc;
-        int     mass;
-        int     collisionSide;
+        SDL_Rect prevPos;
+        BodyStore* store;   //the World's, NULL until added to a Room
+        int     body;
+        Vect    detachedVel;
+        Vect    detachedAcc;
+        int     detachedMass;
         int     shape;
+        bool    asleep;
+        int     restTicks;
+        int     island;
     
     public:
         PhysicalObject(int vx = 0, int vy = 0);
+        PhysicalObject(const PhysicalObject& other);
+        ~PhysicalObject();
+
+        virtual void    setWorld(World* w);
     
         void    setVel(Vect v);
         void    setAcc(Vect a);
+        void    addAcc(double x, double y);
         void    setCollisionSide(int s);
         
         Vect    getVel();
@@ -33,11 +49,25 @@ class PhysicalObject : virtual public Object
         int     getMass();
         int     getCollisionSide();
         int     getShape();
+        int     getBody() {return body;}
+
+        void    savePos() {prevPos = pos;}
+        void    syncActive();
+        SDL_Rect lerpPos(double alpha);
+
+        bool    isAsleep() {return asleep;}
+        int     getRestTicks() {return restTicks;}
+        int     getIsland() {return island;}
+        void    updateRest();
+        void    sleep(int i);
+        void    wake();
     
         void    move();
+        void    step();
     
         virtual void    run();
         virtual void    applyForce(int m, Vect v, int dir = 2);
+        virtual void    impact(Vect v);
 };
 
 #endif
\ No newline at end of file
@@ -12,33 +12,90 @@
 #include "PhysicsEngine.h"
 #include "Geometry.h"
 
-const int FIELD_W = 1280;
-const int FIELD_H = 720;
+const int SLEEP_TICKS = 30;     //ticks at rest before an island may sleep
+
+const double MIN_CONTACT_COS = .0998;  //cos(pi/2 - .1)
+
+/*******************************************************************************
+ Name:              PhysicsEngine
+ Description:       Default constructor for PhysicsEngine class
+
+ Input:
+    threads         Threads to solve contact islands on
+ ******************************************************************************/
+PhysicsEngine::PhysicsEngine(int threads)
+    :   grid(World::FIELD_W, World::FIELD_H),
+        pool(threads)
+{
+    fieldW        = World::FIELD_W;
+    fieldH        = World::FIELD_H;
+    nextIsland    = 0;
+    numAwake      = 0;
+    lastRemoved   = 0;
+}
 
 /*******************************************************************************
  Name:              run
- Description:       Runs all objects in the room and tests for collisions
+ Description:       Runs all objects in the room and tests for collisions.
+                    Called once per fixed tick by Game::run.
  ******************************************************************************/
 void PhysicsEngine::run(Room& room)
 {
+    World& w = room.getWorld();
+
+    if(w.fieldW != fieldW || w.fieldH != fieldH)
+    {
+        fieldW = w.fieldW;
+        fieldH = w.fieldH;
+        grid.resize(fieldW, fieldH);
+    }
+
+    solver.clear(w.bodies);
+    savePositions(room);
     runObjects(room);
     detectCollisions(room);
+    updateSleep();
+}
+
+/*******************************************************************************
+ Name:              savePositions
+ Description:       Remembers where every physical object was before this
+                    tick so the GraphicsEngine can interpolate between ticks,
+                    and marks which bodies the BodyStore should integrate.
+ ******************************************************************************/
+void PhysicsEngine::savePositions(Room& room)
+{
+    vector<PhysicalObject*>& list = room.getBodies();
+
+    for(int i = 0; i < (int)list.size(); i++)
+    {
+        list[i]->savePos();
+        list[i]->syncActive();
+    }
 }
 
 /*******************************************************************************
  Name:              runObjects
  Description:       This method runs every physical object in a given room.
+                    All bodies are integrated in one pass over the BodyStore,
+                    then each object is moved and runs its own logic.
  ******************************************************************************/
 void PhysicsEngine::runObjects(Room& room)
 {
-    for(int i = 0; i < room.getNumObjects(); i++)
+    room.getWorld().bodies.integrate();
+
+    vector<PhysicalObject*>& list = room.getBodies();
+
+    for(int i = 0; i < (int)list.size(); i++)
     {
-        Object* obj = room.getObjectAt(i);
+        PhysicalObject *pObj = list[i];
 
-        if(obj->isPhysical() && obj->getActivePhys())
+        if(pObj->getActivePhys())
         {
-            PhysicalObject *pObj = dynamic_cast<PhysicalObject*>(obj);
+            if(pObj->isAsleep())
+                continue;
 
+            pObj->step();
             pObj->run();
             handleWallCollision(pObj);
         }
@@ -48,109 +105,206 @@ void PhysicsEngine::runObjects(Room& room)
 /*******************************************************************************
  Name:              detectCollisions
  Description:       This method detects collisions between all PhysicalObjects
-                    in a given room.
+                    in a given room. The Broadphase grid narrows the search to
+                    pairs whose bounds overlap; the contacts found, along with
+                    those against the edge of the field, go to the
+                    ContactSolver, which solves each island of touching
+                    bodies on its own thread.
  ******************************************************************************/
 void PhysicsEngine::detectCollisions(Room& room)
 {
-    for(int i = 0; i < room.getNumObjects() - 1; i++)
+    bodies = room.getBodies();
+
+    //a body left the room, whatever it was holding up has to fall. The
+    //count alone would miss a removal and an add in the same tick.
+    int removed = room.getWorld().bodiesRemoved;
+    if(removed != lastRemoved)
+    {
+        for(int i = 0; i < (int)bodies.size(); i++)
+            bodies[i]->wake();
+    }
+    lastRemoved = removed;
+
+    islandOf.resize(bodies.size());
+    for(int i = 0; i < (int)bodies.size(); i++)
+        islandOf[i] = i;
+
+    //only bodies sharing a grid cell are tested against each other
+    grid.rebuild(bodies);
+    grid.findPairs(pairs);
+
+    for(int i = 0; i < (int)pairs.size(); i++)
+    {
+        PhysicalObject *pObj  = bodies[pairs[i].a];
+        PhysicalObject *pObj2 = bodies[pairs[i].b];
+
+        //sleeping bodies are already at rest against each other
+        if(pObj->isAsleep() && pObj2->isAsleep())
+            continue;
+
+        bool    circles = pObj->getShape() == CIRCLE && pObj2->getShape() == CIRCLE;
+        bool    hit;
+        Contact c;
+
+        if(circles)
+            hit = doCollide((CircleObject*)pObj, (CircleObject*)pObj2);
+        else
+            hit = getContact(pObj, pObj2, c);
+
+        if(!hit)
+            continue;
+
+        //an awake body touching a sleeping one wakes its whole island
+        if(pObj->isAsleep())    wakeIsland(pObj->getIsland());
+        if(pObj2->isAsleep())   wakeIsland(pObj2->getIsland());
+
+        joinIslands(pairs[i].a, pairs[i].b);
+
+        if(circles)
+            resolveCollision((CircleObject*)pObj, (CircleObject*)pObj2);
+        else
+            solver.add(pObj, pObj2, c);
+    }
+
+    solver.solve(pool);
+}
+
+/*******************************************************************************
+ Name:              updateSleep
+ Description:       Counts how long each awake body has been at rest, then
+                    puts to sleep every island (set of bodies touching this
+                    tick) whose bodies have all rested for SLEEP_TICKS.
+ ******************************************************************************/
+void PhysicsEngine::updateSleep()
+{
+    int n = (int)bodies.size();
+
+    //cleared for an island's root once any of its bodies is still moving
+    vector<bool> resting(n, true);
+    vector<int>  sleepId(n, -1);
+
+    for(int i = 0; i < n; i++)
+    {
+        PhysicalObject* pObj = bodies[i];
+
+        if(pObj->isAsleep())
+            continue;
+
+        if(pObj->getActivePhys())
+            pObj->updateRest();
+
+        if(!pObj->getActivePhys() || pObj->getRestTicks() < SLEEP_TICKS)
+            resting[findIsland(i)] = false;
+    }
+
+    numAwake = 0;
+
+    for(int i = 0; i < n; i++)
     {
-        Object* obj = room.getObjectAt(i);
+        PhysicalObject* pObj = bodies[i];
 
-        if(obj->isPhysical())
+        if(pObj->isAsleep())
+            continue;
+
+        int root = findIsland(i);
+
+        if(resting[root])
         {
-            PhysicalObject *pObj = dynamic_cast<PhysicalObject*>(obj);
-
-            for(int j = i + 1; j < room.getNumObjects(); j++)
-            {
-                Object* obj2 = room.getObjectAt(j);
-
-                if(obj2->isPhysical())
-                {
-                    PhysicalObject *pObj2 = dynamic_cast<PhysicalObject*>(obj2);
-
-                    if(pObj->getShape() == CIRCLE && pObj2->getShape() == CIRCLE)
-                    {
-                        if(doCollide((CircleObject*)pObj, (CircleObject*)pObj2))
-                            resolveCollision((CircleObject*)pObj, (CircleObject*)pObj2);
-                    }
-                    else
-                    {
-                        if(doCollide(pObj, pObj2))
-                            resolveCollision(pObj, pObj2);
-                    }
-                }
-            }
+            if(sleepId[root] == -1)
+                sleepId[root] = nextIsland++;
+
+            pObj->sleep(sleepId[root]);
         }
+        else
+        {
+            numAwake++;
+        }
+    }
+}
+
+/*******************************************************************************
+ Name:              findIsland, joinIslands, wakeIsland
+ Description:       Union-find over the bodies of the current tick. Sleeping
+                    islands keep the id they were given when they fell asleep.
+ ******************************************************************************/
+int PhysicsEngine::findIsland(int i)
+{
+    while(islandOf[i] != i)
+    {
+        islandOf[i] = islandOf[islandOf[i]];
+        i = islandOf[i];
+    }
+    return i;
+}
+
+void PhysicsEngine::joinIslands(int i, int j)
+{
+    i = findIsland(i);
+    j = findIsland(j);
+
+    if(i < j)       islandOf[j] = i;
+    else if(j < i)  islandOf[i] = j;
+}
+
+void PhysicsEngine::wakeIsland(int island)
+{
+    for(int i = 0; i < (int)bodies.size(); i++)
+    {
+        if(bodies[i]->isAsleep() && bodies[i]->getIsland() == island)
+            bodies[i]->wake();
     }
 }
 
 /*******************************************************************************
  Name:              handleWallCollision
  Description:       This method keeps a PhysicalObject from leaving the
-                    boundaries of the screen.
+                    boundaries of the field. A body at an edge gets a contact
+                    against it, so the ContactSolver stops or bounces it.
  ******************************************************************************/
 void PhysicsEngine::handleWallCollision(PhysicalObject* pObj)
 {
     //get position
     SDL_Rect pos = pObj->getPos();
 
-    //bounce off left/right wall
-    if(pos.x <= 0 || pos.x + pos.w >= FIELD_W)
+    //left/right wall, touching counts so resting bodies keep their contact
+    if(pos.x <= 1 || pos.x + pos.w >= fieldW - 1)
     {
         //adjust position to avoid post-collision issues
-        if(pos.x <= 0)
+        if(pos.x <= 1)
         {
             pos.x = 1;
-            pObj->setCollisionSide(LEFT);
+            solver.addEdge(pObj, Vect(-1, 0), 0, LEFT);
         }
         else
         {
-            pos.x = FIELD_W - pos.w - 1;
-            pObj->setCollisionSide(RIGHT);
+            pos.x = fieldW - pos.w - 1;
+            solver.addEdge(pObj, Vect(1, 0), 0, RIGHT);
         }
         pObj->setPos(pos);
-
-        //adjust velocity
-        Vect v = pObj->getVel();
-        v.x *= -1;
-        v.y = 0;
-        pObj->applyForce(pObj->getMass(), v, 0);
     }
 
-    //bounce off top/bottom wall
-    if(pos.y <= 0 || pos.y + pos.h >= FIELD_H)
+    //top/bottom wall
+    if(pos.y <= 1 || pos.y + pos.h >= fieldH - 1)
     {
         //adjust position to avoid post-collision issues
-        if(pos.y <= 0)
+        if(pos.y <= 1)
         {
             pos.y = 1;
-            pObj->setCollisionSide(TOP);
+            solver.addEdge(pObj, Vect(0, -1), 0, TOP);
         }
         else
         {
-            pos.y = FIELD_H - pos.h - 1;
-            pObj->setCollisionSide(BOTTOM);
+            pos.y = fieldH - pos.h - 1;
+            solver.addEdge(pObj, Vect(0, 1), 0, BOTTOM);
         }
         pObj->setPos(pos);
-
-        //adjust velocity
-        Vect v = pObj->getVel();
-        v.y *= -1;
-        v.x = 0;
-        pObj->applyForce(pObj->getMass(), v, 1);
     }
 }
 
 /*******************************************************************************
  Name:              doCollide
- Description:       Determines if two PhysicalObjects collided
+ Description:       Determines if two CircleObjects collided
  ******************************************************************************/
-bool PhysicsEngine::doCollide(PhysicalObject *a, PhysicalObject *b)
-{
-    //check bounding box collision
-    return doIntersect(a->getPos(), b->getPos());
-}
-
 bool PhysicsEngine::doCollide(CircleObject *a, CircleObject *b)
 {
     return doIntersect(((CircleObject*)a)->getCircle(),
@@ -158,185 +312,61 @@ bool PhysicsEngine::doCollide(CircleObject *a, CircleObject *b)
 }
 
 /*******************************************************************************
- Name:               resolveCollision
- ******************************************************************************/
-void PhysicsEngine::resolveCollision(PhysicalObject* obj, PhysicalObject* obj2)
-{
-    int sideA, sideB;
-
-    //evaluate side of collision for both objects
-    sideA = sideOfCollision(obj, obj2);
-
-    if(sideA)
-    {
-        //determine side of obj2
-        if(sideA - 4 <= 0)  sideB = sideA + 4;
-        else                sideB = sideA - 4;
-
-        //react to collision
-        handleCollision_Box(obj, obj2, sideB);
-        handleCollision_Box(obj2, obj, sideA);
-    }
-}
-
-void PhysicsEngine::resolveCollision(CircleObject* obj, CircleObject* obj2)
-{
-    handleCollision(obj, obj2);
-    handleCollision(obj2, obj);
-}
+ Name:              getContact
+ Description:       Finds the contact between two PhysicalObjects when at
+                    least one of them is a box
 
-/*******************************************************************************
- Name:              sideOfCollision
+ Output:
+    c               The contact, normal pointing from a to b
+    returns         false if they do not touch
  ******************************************************************************/
-int PhysicsEngine::sideOfCollision(PhysicalObject* obj, PhysicalObject* obj2)
+bool PhysicsEngine::getContact(PhysicalObject* a, PhysicalObject* b, Contact& c)
 {
-    //get bounding boxes
-    SDL_Rect a = obj->getPos();
-    SDL_Rect b = obj2->getPos();
-
-    //assume 4-sided collision
-    bool aTop    = true;
-    bool aRight  = true;
-    bool aBottom = true;
-    bool aLeft   = true;
-
-    //evaluate initial collision sides
-    if(a.y > b.y)               aBottom = false;
-    if(a.x > b.x)               aRight  = false;
-    if(a.y + a.h < b.y + b.h)   aTop    = false;
-    if(a.x + a.w < b.x + b.w)   aLeft   = false;
-
-    //evaluate impossible 3-side collision case
-    if(aTop + aBottom + aRight + aLeft == 3)
-    {
-        if(aTop && aBottom)     aTop = aBottom = false;
-        else                    aLeft = aRight = false;
-    }
+    if(a->getShape() == CIRCLE)
+        return findContact(((CircleObject*)a)->getCircle(), b->getPos(), c);
 
-    //eliminate impossible corner cases
-    if(aTop + aBottom + aRight + aLeft == 2)
+    if(b->getShape() == CIRCLE)
     {
-        Vect velA = obj->getVel();
-        Vect velB = obj2->getVel();
-
-        //avoid getting trapped within objects
-        if(velA.x > 0 && velB.x < 0) aLeft      = false;
-        if(velA.x < 0 && velB.x > 0) aRight     = false;
-        if(velA.y > 0 && velB.y < 0) aTop       = false;
-        if(velA.y < 0 && velB.y > 0) aBottom    = false;
-
-        //impossible collision case
-        if(velA.x == velB.x) aLeft = aRight = false;
-        if(velA.y == velB.y) aTop = aBottom = false;
-
-        //avoid side-by-side motionless collisions
-        if(!velA.x && !velB.x && (a.x == b.x + b.w || a.x == b.x - a.w))
-            aLeft = aRight = aTop = aBottom = false;
-        if(!velA.y && !velB.y && (a.y == b.y + b.h || a.y == b.y - a.h))
-            aLeft = aRight = aTop = aBottom = false;
-    }
-
-    //evaluate corner case
-    if(aTop + aBottom + aRight + aLeft == 2)
-    {
-        Vect velA = obj->getVel();
-        Vect velB = obj2->getVel();
-
-        double tx, ty;
+        if(!findContact(((CircleObject*)b)->getCircle(), a->getPos(), c))
+            return false;
 
-        if(aTop)            ty = abs(a.y - (b.y + b.h)) / abs(velA.y - velB.y);
-        else if(aBottom)    ty = abs((a.y + a.h) - b.y) / abs(velA.y - velB.y);
-
-        if(aLeft)           tx = abs(a.x - (b.x + b.w)) / abs(velA.x - velB.x);
-        else if(aRight)     tx = abs((a.x + a.w) - b.x) / abs(velA.x - velB.x);
-
-        if(ty > tx)         aTop = aBottom = false;
-        else if(ty < tx)    aLeft = aRight = false;
+        c.normal = c.normal * -1;
+        return true;
     }
 
-    //return collision code
-    if(aTop)
-    {
-        if(aLeft)   return TOP_LEFT;
-        if(aRight)  return TOP_RIGHT;
-        return TOP;
-    }
-    if(aBottom)
-    {
-        if(aLeft)   return BOTTOM_LEFT;
-        if(aRight)  return BOTTOM_RIGHT;
-        return BOTTOM;
-    }
-    if(aLeft)   return LEFT;
-    if(aRight)  return RIGHT;
-    return NO_COLLISION;
+    return findContact(a->getPos(), b->getPos(), c);
 }
 
 /*******************************************************************************
- Name:              handleCollision_Box
+ Name:               resolveCollision
  ******************************************************************************/
-void PhysicsEngine::handleCollision_Box(PhysicalObject* obj, PhysicalObject* obj2, int side)
+void PhysicsEngine::resolveCollision(CircleObject* obj, CircleObject* obj2)
 {
-    if(side == TOP || side == BOTTOM)
-    {
-        //adjust position to avoid post-collision problem
-        SDL_Rect a = obj2->getPos();
-        if(side == TOP) a.y++;
-        else a.y--;
-        obj2->setPos(a);
-
-        //adjust velocity based on force of collision
-        Vect v = obj->getVel();
-        v.x = 0;
-        obj2->applyForce(obj->getMass(), v, 1);
-    }
-    else if(side == LEFT || side == RIGHT)
-    {
-        //adjust position to avoid post-collision problem
-        SDL_Rect a = obj2->getPos();
-        if(side == LEFT) a.x++;
-        else a.x--;
-        obj2->setPos(a);
-
-        //adjust velocity based on force of collision
-        Vect v = obj->getVel();
-        v.y = 0;
-        obj2->applyForce(obj->getMass(), v, 0);
-    }
-    else
-    {
-        //adjust velocity based on force of collision
-        Vect v = obj->getVel();
-        obj2->applyForce(obj->getMass(), v, 2);
-    }
-
-    //record collision side
-    obj2->setCollisionSide(side);
+    handleCollision(obj, obj2);
+    handleCollision(obj2, obj);
 }
 
 /*******************************************************************************
  Name:              handleCollision_Circle
+ Description:       Pushes obj2 with the part of obj's velocity that points
+                    along the contact normal, and takes it off obj
  ******************************************************************************/
 void PhysicsEngine::handleCollision(CircleObject* obj, CircleObject* obj2)
 {
-    Circle a = obj->getCircle();
-    Circle b = obj2->getCircle();
+    Contact c;
 
-    Point i = pointOfIntersection(a, b);
-    Vect  l = Vect(i, b.cent);
+    if(!findContact(obj->getCircle(), obj2->getCircle(), c))
+        return;
 
-    double ang1 = l.angle();
-    double ang2 = obj->getVel().angle();
-    double ang3 = ang2 - ang1;
+    //split obj's velocity into the part along the contact normal
+    Vect   vel   = obj->getVel();
+    double speed = vel.len();
+    double fm    = vel.dot(c.normal);
 
-    if(abs(ang3) <= (M_PI / 2) - .1 && obj->getVel().len()) //.1 accounts for rounding error
+    //only when heading into obj2, MIN_CONTACT_COS allows for rounding error
+    if(speed && fm >= speed * MIN_CONTACT_COS)
     {
-        double fa = obj->getVel().len();
-        double fm = fa * cos(ang3);
-        double fs = fa * sin(ang3);
-
-        Vect m = Vect(fm * cos(ang1), fm * sin(ang1));
-        Vect s = Vect(fs * sin(ang1), fs * cos(ang1));  //USED FOR SPIN MAYBE?
+        Vect m = c.normal * fm;
 
         obj2->applyForce(obj->getMass(), m);
 
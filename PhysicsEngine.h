@@ -15,27 +15,55 @@
 #include "Room.h"
 #include "PhysicalObject.h"
 #include "CircleObject.h"
+#include "Broadphase.h"
+#include "ContactSolver.h"
+#include "ThreadPool.h"
 
 class PhysicsEngine
 {
     public:
+        PhysicsEngine(int threads = ThreadPool::numCores());
+
         void run(Room& room);
+
+        int  getNumCandidatePairs() {return grid.getNumPairs();}
+        int  getNumAwake() {return numAwake;}
+        int  getNumContacts() {return solver.getNumContacts();}
+        int  getNumIslands() {return solver.getNumIslands();}
+        int  getNumThreads() {return pool.getNumThreads();}
+
+        void setSolverIterations(int iter) {solver.setIterations(iter);}
+        void setNumThreads(int threads) {pool.setNumThreads(threads);}
     
     private:
+        Broadphase              grid;
+        int                     fieldW;     //of the room, as the grid covers
+        int                     fieldH;
+        ThreadPool              pool;
+        ContactSolver           solver;
+        vector<PhysicalObject*> bodies;
+        vector<BodyPair>        pairs;
+        vector<int>             islandOf;
+        int                     nextIsland;
+        int                     numAwake;
+        int                     lastRemoved;    //World::bodiesRemoved seen
+
+        void savePositions(Room& room);
         void runObjects(Room& room);
         void detectCollisions(Room& room);
+        void updateSleep();
+
+        int  findIsland(int i);
+        void joinIslands(int i, int j);
+        void wakeIsland(int island);
     
         void handleWallCollision(PhysicalObject* pObj);
     
-        bool doCollide(PhysicalObject* a, PhysicalObject* b);
         bool doCollide(CircleObject* a, CircleObject* b);
+        bool getContact(PhysicalObject* a, PhysicalObject* b, Contact& c);
     
-        void resolveCollision(PhysicalObject* obj, PhysicalObject* obj2);
         void resolveCollision(CircleObject* obj, CircleObject* obj2);
     
-        int  sideOfCollision(PhysicalObject* obj, PhysicalObject* obj2);
-    
-        void handleCollision_Box(PhysicalObject* obj, PhysicalObject* obj2, int side);
         void handleCollision(CircleObject* obj, CircleObject* obj2);
 };
 
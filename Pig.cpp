@@ -1,15 +1,12 @@
 #include "Pig.h"
 #include <cmath>
 
-int Pig::numPigs = 0;
-
 Pig::Pig(const char* file, int x, int y, int vx, int vy)
     :   Object(x, y, 20, 20),
         DrawableObject(file, 2),
         PhysicalObject(vx, vy)
 {
     health = 100;
-    numPigs++;
 
     activeDraw = true;
     activePhys = true;
@@ -22,29 +19,40 @@ Pig::Pig(const Pig& other)
         DrawableObject("TestA.bmp", 2),
         PhysicalObject(other.pos.x, other.pos.y)
 {
-    numPigs++;
 }
 
 Pig::~Pig()
 {
-    numPigs--;
+    if(world)
+        world->numPigs--;
     adjustScore(100);
 }
 
-void Pig::run()
+/*******************************************************************************
+ Name:              setWorld
+ Description:       Counts the pig in the world it joins, for the win check
+ ******************************************************************************/
+void Pig::setWorld(World* w)
 {
-    move();
+    if(world)
+        world->numPigs--;
+
+    PhysicalObject::setWorld(w);
+
+    if(world)
+        world->numPigs++;
+}
 
+void Pig::run()
+{
     if(health <= 0)
     {
         state = -1;
     }
 }
 
-void Pig::applyForce(int m, Vect v, int dir)
+void Pig::impact(Vect v)
 {
-    PhysicalObject::applyForce(m, v, dir);
-
     if(pow((pow(v.y,2.0) + pow(v.x, 2.0)), .5) > 7)
     {
         health -= 50;
@@ -8,7 +8,6 @@ class Pig : public DrawableObject, public PhysicalObject, public MechanicsObject
 {
     private:
         int health;
-        static int numPigs;
 
     public:
         Pig(const char* file, int x, int y, int vx, int vy);
@@ -16,8 +15,8 @@ class Pig : public DrawableObject, public PhysicalObject, public MechanicsObject
         ~Pig();
 
         virtual void    run();
-        void            applyForce(int m, Vect v, int dir);
-        static int      getNumPigs() {return numPigs;}
+        void            impact(Vect v);
+        void            setWorld(World* w);
         void            pause();
         void            unpause();
 };
@@ -0,0 +1,340 @@
+/*******************************************************************************
+ Filename:                  Prefetcher.cpp
+ Classname:                 Prefetcher
+
+ Description:               This file defines the Prefetcher class.
+ ******************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include "Prefetcher.h"
+#include "TextureCache.h"
+
+static bool endsWith(const string& s, const char* end)
+{
+    size_t n = strlen(end);
+
+    return s.size() >= n && s.compare(s.size() - n, n, end) == 0;
+}
+
+/*******************************************************************************
+ Name:              Prefetcher
+ Description:       Constructor. The thread does not run until start().
+ ******************************************************************************/
+Prefetcher::Prefetcher()
+{
+    loader    = NULL;
+    lock      = SDL_CreateMutex();
+    work      = SDL_CreateCond();
+    done      = SDL_CreateCond();
+    quit      = false;
+    numTaken  = 0;
+    numWasted = 0;
+}
+
+Prefetcher::~Prefetcher()
+{
+    stop();
+
+    SDL_DestroyCond(done);
+    SDL_DestroyCond(work);
+    SDL_DestroyMutex(lock);
+}
+
+/*******************************************************************************
+ Name:              start, stop
+ Description:       Starts the thread, and stops it, freeing every image
+                    decoded and never taken
+ ******************************************************************************/
+void Prefetcher::start()
+{
+    if(loader)
+        return;
+
+    quit   = false;
+    loader = SDL_CreateThread(loaderMain, this);
+}
+
+void Prefetcher::stop()
+{
+    if(!loader)
+        return;
+
+    SDL_LockMutex(lock);
+    quit = true;
+    queue.clear();
+    SDL_CondSignal(work);
+    SDL_UnlockMutex(lock);
+
+    SDL_WaitThread(loader, NULL);
+    loader = NULL;
+
+    for(map<string, SDL_Surface*>::iterator it = ready.begin(); it != ready.end(); ++it)
+    {
+        SDL_FreeSurface(it->second);
+        numWasted++;
+    }
+    ready.clear();
+}
+
+int Prefetcher::loaderMain(void* data)
+{
+    ((Prefetcher*)data)->decodeQueue();
+    return 0;
+}
+
+/*******************************************************************************
+ Name:              decodeQueue
+ Description:       The thread: decodes the queue front first, without the
+                    lock held, until stop()
+ ******************************************************************************/
+void Prefetcher::decodeQueue()
+{
+    SDL_LockMutex(lock);
+
+    while(!quit)
+    {
+        if(queue.empty())
+        {
+            SDL_CondWait(work, lock);
+            continue;
+        }
+
+        string image = queue.front();
+        queue.pop_front();
+        current = image;
+        SDL_UnlockMutex(lock);
+
+        SDL_Surface* s = TextureCache::decode(image.c_str());
+
+        SDL_LockMutex(lock);
+        current.clear();
+
+        if(s)
+            ready[image] = s;
+        else
+            failed.insert(image);
+
+        SDL_CondBroadcast(done);
+    }
+
+    SDL_UnlockMutex(lock);
+}
+
+/*******************************************************************************
+ Name:              imagesOf
+ Description:       The images a level names, its background first, read
+                    from its .gel the first time it is asked for
+ ******************************************************************************/
+vector<string>& Prefetcher::imagesOf(const string& level)
+{
+    map<string, vector<string> >::iterator it = images.find(level);
+
+    if(it != images.end())
+        return it->second;
+
+    vector<string>& list = images[level];
+    ifstream        inFile(level.c_str());
+    string          word;
+
+    while(inFile >> word)
+    {
+        if(endsWith(word, ".bmp") && find(list.begin(), list.end(), word) == list.end())
+            list.push_back(word);
+    }
+
+    return list;
+}
+
+/*******************************************************************************
+ Name:              isPending
+ Description:       Whether the thread has an image queued, in hand or done.
+                    Call with the lock held.
+ ******************************************************************************/
+bool Prefetcher::isPending(const string& image)
+{
+    return current == image || ready.count(image) || failed.count(image)
+           || find(queue.begin(), queue.end(), image) != queue.end();
+}
+
+/*******************************************************************************
+ Name:              prefetch
+ Description:       Replaces the queue with the images of the levels that
+                    can come next, in the order given, and frees images
+                    decoded for levels that no longer can
+
+ Input:
+    levels          The .gel files
+ ******************************************************************************/
+void Prefetcher::prefetch(const vector<string>& levels)
+{
+    if(!loader)
+        return;
+
+    vector<string> wanted;
+
+    for(int i = 0; i < (int)levels.size(); i++)
+    {
+        vector<string>& list = imagesOf(levels[i]);
+
+        for(int j = 0; j < (int)list.size(); j++)
+        {
+            if(!TextureCache::isLoaded(list[j].c_str())
+               && find(wanted.begin(), wanted.end(), list[j]) == wanted.end())
+                wanted.push_back(list[j]);
+        }
+    }
+
+    SDL_LockMutex(lock);
+
+    queue.clear();
+
+    //an image that failed before gets another try
+    for(int i = 0; i < (int)wanted.size(); i++)
+    {
+        failed.erase(wanted[i]);
+
+        if(!isPending(wanted[i]))
+            queue.push_back(wanted[i]);
+    }
+
+    map<string, SDL_Surface*>::iterator it = ready.begin();
+
+    while(it != ready.end())
+    {
+        if(find(wanted.begin(), wanted.end(), it->first) == wanted.end())
+        {
+            SDL_FreeSurface(it->second);
+            ready.erase(it++);
+            numWasted++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    SDL_CondSignal(work);
+    SDL_UnlockMutex(lock);
+}
+
+/*******************************************************************************
+ Name:              hurry
+ Description:       Moves the images of a level about to load to the front
+                    of the queue, queueing any it lacks, and any that failed
+                    before for another try
+ ******************************************************************************/
+void Prefetcher::hurry(const string& level)
+{
+    if(!loader)
+        return;
+
+    vector<string>& list = imagesOf(level);
+
+    SDL_LockMutex(lock);
+
+    for(int i = (int)list.size() - 1; i >= 0; i--)
+    {
+        if(TextureCache::isLoaded(list[i].c_str()) || current == list[i]
+           || ready.count(list[i]))
+            continue;
+
+        failed.erase(list[i]);
+
+        deque<string>::iterator it = find(queue.begin(), queue.end(), list[i]);
+
+        if(it != queue.end())
+            queue.erase(it);
+        queue.push_front(list[i]);
+    }
+
+    SDL_CondSignal(work);
+    SDL_UnlockMutex(lock);
+}
+
+/*******************************************************************************
+ Name:              isReady
+ Description:       Whether every image a level names is loaded or decoded,
+                    so loading it will not wait on the disk. Images that
+                    could not be decoded count as ready; the level fails to
+                    load them as it would have anyway.
+ ******************************************************************************/
+bool Prefetcher::isReady(const string& level)
+{
+    if(!loader)
+        return true;
+
+    vector<string>& list = imagesOf(level);
+    bool            yes  = true;
+
+    SDL_LockMutex(lock);
+
+    for(int i = 0; i < (int)list.size() && yes; i++)
+    {
+        yes = TextureCache::isLoaded(list[i].c_str())
+              || ready.count(list[i]) || failed.count(list[i]);
+    }
+
+    SDL_UnlockMutex(lock);
+
+    return yes;
+}
+
+/*******************************************************************************
+ Name:              take
+ Description:       Hands over a decoded image, waiting for it if the thread
+                    is decoding it now. One still queued is dropped from the
+                    queue, for the caller to decode itself.
+
+ Input:
+    image           The .bmp file
+
+ Output:
+    returns         The surface, now the caller's, or NULL
+ ******************************************************************************/
+SDL_Surface* Prefetcher::take(const char* image)
+{
+    if(!loader)
+        return NULL;
+
+    SDL_Surface* s = NULL;
+
+    SDL_LockMutex(lock);
+
+    while(current == image)
+        SDL_CondWait(done, lock);
+
+    map<string, SDL_Surface*>::iterator it = ready.find(image);
+
+    if(it != ready.end())
+    {
+        s = it->second;
+        ready.erase(it);
+        numTaken++;
+    }
+    else
+    {
+        deque<string>::iterator q = find(queue.begin(), queue.end(), image);
+
+        if(q != queue.end())
+            queue.erase(q);
+    }
+
+    SDL_UnlockMutex(lock);
+
+    return s;
+}
+
+/*******************************************************************************
+ Name:              report
+ Description:       Prints how many decoded images were used, and how many
+                    were not
+ ******************************************************************************/
+void Prefetcher::report()
+{
+    cout << "prefetch: " << numTaken << " images taken, "
+         << numWasted << " decoded and never used" << endl;
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ Filename:                  Prefetcher.h
+ Classname:                 Prefetcher
+
+ Description:               This file declares the Prefetcher class. The
+                            Prefetcher decodes images ahead of time on a
+                            thread of its own. Given the levels that can be
+                            picked from the screen on show, it reads each
+                            .gel for the images it names and queues those the
+                            TextureCache does not hold already. The thread
+                            decodes them with TextureCache::decode and keeps
+                            them until TextureCache::load take()s them, so a
+                            level whose images are all ready loads without
+                            touching the disk.
+
+                            Only the main thread calls its methods; the
+                            decoded surfaces are handed over under a lock,
+                            and the TextureCache itself is only touched from
+                            the main thread. Images still ready when the
+                            candidates change, and no longer wanted, are
+                            freed.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Prefetcher_h
+#define AngrySomething_Prefetcher_h
+
+#include <map>
+#include <set>
+#include <deque>
+#include <string>
+#include <vector>
+#include <SDL/SDL.h>
+
+using namespace std;
+
+class Prefetcher
+{
+    private:
+        SDL_Thread*                     loader;
+        SDL_mutex*                      lock;
+        SDL_cond*                       work;       //the queue has images
+        SDL_cond*                       done;       //an image was decoded
+
+        //guarded by lock
+        deque<string>                   queue;
+        string                          current;    //being decoded
+        map<string, SDL_Surface*>       ready;
+        set<string>                     failed;
+        bool                            quit;
+
+        map<string, vector<string> >    images;     //by level, main thread only
+        int                             numTaken;
+        int                             numWasted;
+
+        static int      loaderMain(void* data);
+        void            decodeQueue();
+        vector<string>& imagesOf(const string& level);
+        bool            isPending(const string& image);
+
+    public:
+        Prefetcher();
+        ~Prefetcher();
+
+        void            start();
+        void            stop();
+        bool            isRunning() {return loader != NULL;}
+
+        void            prefetch(const vector<string>& levels);
+        void            hurry(const string& level);
+        bool            isReady(const string& level);
+        SDL_Surface*    take(const char* image);
+
+        int             getNumTaken() {return numTaken;}
+        int             getNumWasted() {return numWasted;}
+        void            report();
+};
+
+#endif
@@ -8,8 +8,6 @@
 #include "Projectile.h"
 #include <cmath>
 
-int Projectile::numBirds = 0;
-
 Projectile::Projectile(const char* file, int x, int y, int vx, int vy)
     :   Object(x, y, 50, 50),
         DrawableObject(file, 2),
@@ -17,7 +15,6 @@ Projectile::Projectile(const char* file, int x, int y, int vx, int vy)
 
 {
     type = 1;
-    numBirds++;
     activeDraw = true;
     activePhys = true;
     activeMech = false;
@@ -26,13 +23,31 @@ Projectile::Projectile(const char* file, int x, int y, int vx, int vy)
 
 Projectile::~Projectile()
 {
-    numBirds--;
+    if(world)
+        world->numBirds--;
+}
+
+/*******************************************************************************
+ Name:              setWorld
+ Description:       Counts the bird as in flight in the world it joins
+ ******************************************************************************/
+void Projectile::setWorld(World* w)
+{
+    if(world)
+        world->numBirds--;
+
+    PhysicalObject::setWorld(w);
+
+    if(world)
+        world->numBirds++;
 }
 
 void Projectile::run()
 {
     CircleObject::run();
 
+    Vect vel = getVel();
+
     if(pow(pow(vel.y, 2.0) + pow(vel.x, 2.0), .5) < 1)
     {
         state = -1;
@@ -41,10 +56,9 @@ void Projectile::run()
 
 void Projectile::draw(SDL_Surface* screen)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect loc = pos;
 
-    SDL_BlitSurface(image, NULL, screen, &loc);
+    Blitter::blit(image, &frame, screen, &loc);
 }
 
 void Projectile::pause()
@@ -14,17 +14,15 @@
 
 class Projectile : public DrawableObject, public CircleObject, public MechanicsObject
 {
-    protected:
-        static int numBirds;
-
     public:
         Projectile(const char* file, int x, int y, int vx, int vy);
         ~Projectile();
 
-        static int      getNumBirds() {return numBirds;}
+        void            setWorld(World* w);
 
         virtual void    run();
         void            draw(SDL_Surface* s);
+        SDL_Rect        getBounds() {return imageBounds();}
         void            pause();
         void            unpause();
 };
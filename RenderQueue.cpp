@@ -0,0 +1,302 @@
+/*******************************************************************************
+ Filename:                  RenderQueue.cpp
+ Classname:                 RenderQueue
+
+ Description:               This file defines the RenderQueue class.
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include "RenderQueue.h"
+#include "DrawableObject.h"
+#include "PhysicalObject.h"
+#include "Geometry.h"
+
+const int CELL   = 256;     //px on a side of a grid cell
+const int MARGIN = 8;       //px around the bounds an object is filed by,
+                            //for what prepare() may add
+
+/*******************************************************************************
+ Name:              RenderQueue
+ Description:       Constructor
+ ******************************************************************************/
+RenderQueue::RenderQueue()
+{
+    numShowing = 0;
+    stale      = true;
+    cols       = 0;
+    rows       = 0;
+    numQueries = 0;
+}
+
+/*******************************************************************************
+ Name:              insert
+ Description:       Queues an object at the end of its layer, if it is
+                    showing
+ ******************************************************************************/
+void RenderQueue::insert(const DrawEntry& e)
+{
+    if(!e.obj->getActiveDraw())
+        return;
+
+    int layer = max(e.obj->getLayer(), 0);
+
+    if(layer >= (int)buckets.size())
+        buckets.resize(layer + 1);
+
+    buckets[layer].push_back(e);
+    numShowing++;
+    stale = true;
+}
+
+/*******************************************************************************
+ Name:              sweep
+ Description:       Takes out the objects being destroyed, keeping the order
+                    of the rest
+
+ Input:
+    dead            The objects, sorted
+ ******************************************************************************/
+void RenderQueue::sweep(vector<Object*>& dead)
+{
+    numShowing = 0;
+
+    for(int l = 0; l < (int)buckets.size(); l++)
+    {
+        vector<DrawEntry>& b = buckets[l];
+        int kept = 0;
+
+        for(int i = 0; i < (int)b.size(); i++)
+        {
+            if(!binary_search(dead.begin(), dead.end(), (Object*)b[i].obj))
+                b[kept++] = b[i];
+        }
+        b.resize(kept);
+        numShowing += kept;
+    }
+
+    stale = true;
+}
+
+/*******************************************************************************
+ Name:              rebuild
+ Description:       Queues again every object that is showing, after pausing
+                    or unpausing changed which are
+
+ Input:
+    all             Every drawable object in the room, in the order added
+ ******************************************************************************/
+void RenderQueue::rebuild(vector<DrawEntry>& all)
+{
+    clear();
+
+    for(int i = 0; i < (int)all.size(); i++)
+        insert(all[i]);
+}
+
+/*******************************************************************************
+ Name:              clear
+ Description:       Empties the buckets, keeping their memory
+ ******************************************************************************/
+void RenderQueue::clear()
+{
+    for(int l = 0; l < (int)buckets.size(); l++)
+        buckets[l].clear();
+
+    numShowing = 0;
+    stale      = true;
+}
+
+/*******************************************************************************
+ Name:              collect
+ Description:       Lists the objects to draw this frame, lowest layer first
+
+ Output:
+    out             Replaced with the list; reuse the same vector every frame
+                    so it is not allocated again
+ ******************************************************************************/
+void RenderQueue::collect(vector<DrawEntry>& out)
+{
+    out.clear();
+
+    for(int l = 0; l < (int)buckets.size(); l++)
+        out.insert(out.end(), buckets[l].begin(), buckets[l].end());
+}
+
+/*******************************************************************************
+ Name:              query
+ Description:       Lists the objects that can be seen in a view of the
+                    field this frame, lowest layer first, as collect() would
+                    with the rest left out
+
+ Input:
+    view            The part of the field on the screen
+    fieldW, fieldH  Size of the field
+
+ Output:
+    out             Replaced with the list
+ ******************************************************************************/
+void RenderQueue::query(SDL_Rect view, int fieldW, int fieldH, vector<DrawEntry>& out)
+{
+    if(stale || cols != fieldW / CELL + 1 || rows != fieldH / CELL + 1)
+        regrid(fieldW, fieldH);
+
+    //file again what may have moved since the last query
+    for(int k = 0; k < (int)movers.size(); k++)
+    {
+        int        i = movers[k];
+        DrawEntry& e = order[i];
+
+        if(e.body && e.body->isAsleep())
+            continue;
+
+        SDL_Rect r = reach(e);
+        int      a1, b1, a2, b2, x1, y1, x2, y2;
+
+        span(filed[i], a1, b1, a2, b2);
+        span(r, x1, y1, x2, y2);
+
+        if(a1 != x1 || b1 != y1 || a2 != x2 || b2 != y2)
+        {
+            file(i, filed[i], false);
+            file(i, r, true);
+        }
+        filed[i] = r;
+    }
+
+    numQueries++;
+    found = fixedOnes;
+
+    int x1, y1, x2, y2;
+    span(view, x1, y1, x2, y2);
+
+    for(int y = y1; y <= y2; y++)
+    {
+        for(int x = x1; x <= x2; x++)
+        {
+            vector<int>& cell = cells[y * cols + x];
+
+            for(int k = 0; k < (int)cell.size(); k++)
+            {
+                int i = cell[k];
+
+                if(seen[i] != numQueries && doIntersect(filed[i], view))
+                {
+                    seen[i] = numQueries;
+                    found.push_back(i);
+                }
+            }
+        }
+    }
+
+    //back into layer order
+    sort(found.begin(), found.end());
+
+    out.clear();
+    for(int k = 0; k < (int)found.size(); k++)
+        out.push_back(order[found[k]]);
+}
+
+/*******************************************************************************
+ Name:              regrid
+ Description:       Files every object showing again, in a grid over a
+                    field of the given size
+ ******************************************************************************/
+void RenderQueue::regrid(int fieldW, int fieldH)
+{
+    cols = fieldW / CELL + 1;
+    rows = fieldH / CELL + 1;
+
+    for(int c = 0; c < (int)cells.size(); c++)
+        cells[c].clear();
+    cells.resize(cols * rows);
+
+    collect(order);
+
+    filed.resize(order.size());
+    seen.assign(order.size(), 0);
+    fixedOnes.clear();
+    movers.clear();
+
+    for(int i = 0; i < (int)order.size(); i++)
+    {
+        if(order[i].obj->isFixed())
+        {
+            fixedOnes.push_back(i);
+            continue;
+        }
+
+        filed[i] = reach(order[i]);
+        file(i, filed[i], true);
+        movers.push_back(i);
+    }
+
+    stale = false;
+}
+
+/*******************************************************************************
+ Name:              file
+ Description:       Adds an object to, or takes it out of, every cell some
+                    bounds touch
+ ******************************************************************************/
+void RenderQueue::file(int i, SDL_Rect r, bool add)
+{
+    int x1, y1, x2, y2;
+    span(r, x1, y1, x2, y2);
+
+    for(int y = y1; y <= y2; y++)
+    {
+        for(int x = x1; x <= x2; x++)
+        {
+            vector<int>& cell = cells[y * cols + x];
+
+            if(add)
+                cell.push_back(i);
+            else
+                cell.erase(find(cell.begin(), cell.end(), i));
+        }
+    }
+}
+
+/*******************************************************************************
+ Name:              reach
+ Description:       Everything an object may draw on this frame: its bounds,
+                    and for a body, those bounds anywhere between the last
+                    two ticks, plus MARGIN
+ ******************************************************************************/
+SDL_Rect RenderQueue::reach(DrawEntry& e)
+{
+    SDL_Rect r = e.obj->getBounds();
+
+    if(e.body)
+    {
+        SDL_Rect now  = e.body->getPos();
+        SDL_Rect last = e.body->lerpPos(0);
+        SDL_Rect was  = r;
+
+        was.x += last.x - now.x;
+        was.y += last.y - now.y;
+        r = unite(r, was);
+    }
+
+    r.x -= MARGIN;
+    r.y -= MARGIN;
+    r.w += 2 * MARGIN;
+    r.h += 2 * MARGIN;
+
+    return r;
+}
+
+/*******************************************************************************
+ Name:              span
+ Description:       The cells some bounds touch, edges inclusive to match
+                    doIntersect. Anything off the field is clamped into the
+                    border cells.
+ ******************************************************************************/
+void RenderQueue::span(SDL_Rect r, int& x1, int& y1, int& x2, int& y2)
+{
+    x1 = max(0, min(r.x / CELL, cols - 1));
+    y1 = max(0, min(r.y / CELL, rows - 1));
+    x2 = max(0, min((r.x + r.w) / CELL, cols - 1));
+    y2 = max(0, min((r.y + r.h) / CELL, rows - 1));
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ Filename:                  RenderQueue.h
+ Classname:                 RenderQueue
+
+ Description:               This file declares the RenderQueue class. The
+                            RenderQueue holds the drawable objects of a Room
+                            that are showing, in one bucket per layer, each
+                            bucket in the order the objects were added. Room
+                            keeps it up to date as objects come and go and
+                            when the room is paused or unpaused (the only time
+                            an object's activeDraw changes), so drawing a
+                            frame only walks the buckets: no sort and, once
+                            the buckets have grown, no allocation.
+
+                            For fields bigger than the screen, query() finds
+                            just the objects the camera can see through a
+                            grid of cells over the field, each object filed
+                            in the cells its bounds reach. Bodies are filed
+                            again each frame only while awake, and the few
+                            other objects every frame, so a frame costs what
+                            is on the screen and what is moving, not the
+                            whole level. Fixed objects are always found.
+ ******************************************************************************/
+
+#ifndef AngrySomething_RenderQueue_h
+#define AngrySomething_RenderQueue_h
+
+#include <vector>
+#include <SDL/SDL.h>
+
+class Object;
+class DrawableObject;
+class PhysicalObject;
+
+using namespace std;
+
+/*******************************************************************************
+ Struct DrawEntry
+ Description:       A drawable object, with the PhysicalObject it also is (or
+                    NULL) so the GraphicsEngine can interpolate it
+ ******************************************************************************/
+struct DrawEntry
+{
+    DrawableObject*     obj;
+    PhysicalObject*     body;
+};
+
+class RenderQueue
+{
+    private:
+        vector< vector<DrawEntry> > buckets;    //by layer
+        int                         numShowing;
+
+        //the grid, rebuilt when the buckets change or the field does
+        bool                        stale;
+        int                         cols;
+        int                         rows;
+        vector< vector<int> >       cells;      //indices into order
+        vector<DrawEntry>           order;      //what collect() gives
+        vector<SDL_Rect>            filed;      //bounds each is filed by
+        vector<int>                 seen;       //last query that found each
+        vector<int>                 fixedOnes;
+        vector<int>                 movers;
+        vector<int>                 found;
+        int                         numQueries;
+
+        void    regrid(int fieldW, int fieldH);
+        void    file(int i, SDL_Rect r, bool add);
+        SDL_Rect reach(DrawEntry& e);
+        void    span(SDL_Rect r, int& x1, int& y1, int& x2, int& y2);
+
+    public:
+        RenderQueue();
+
+        void    insert(const DrawEntry& e);
+        void    sweep(vector<Object*>& dead);
+        void    rebuild(vector<DrawEntry>& all);
+        void    clear();
+
+        void    collect(vector<DrawEntry>& out);
+        void    query(SDL_Rect view, int fieldW, int fieldH, vector<DrawEntry>& out);
+        int     getNumShowing() {return numShowing;}
+};
+
+#endif
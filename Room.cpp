@@ -5,10 +5,15 @@
  Description:               This file defines the Room class.
  ******************************************************************************/
 
+#include <algorithm>
+
 #include "Room.h"
 #include "Object.h"
 #include "DrawableObject.h"
 #include "PhysicalObject.h"
+#include "MechanicsObject.h"
+#include "ControllableObject.h"
+#include "AudibleObject.h"
 #include "Sling.h"
 #include "Wall.h"
 #include "Pig.h"
@@ -17,6 +22,7 @@
 #include "MenuItem.h"
 #include "NonInteractionObject.h"
 #include "DestructableWall.h"
+#include "TextureCache.h"
 
 /*******************************************************************************
  ACCESSORS
@@ -25,11 +31,13 @@
 Room::Room()
 {
     roomType = Level;
+    background = NULL;
 }
 
 Room::~Room()
 {
-    SDL_FreeSurface(background);
+    erase();
+    TextureCache::release(background);
 }
 
 /*******************************************************************************
@@ -46,25 +54,128 @@ int Room::getNumObjects()
     return (int)object.size();
 }
 
-void Room::remove(int i)
+/*******************************************************************************
+ Name:              remove
+ Description:       Marks an object for removal. It stays in the room, and
+                    indices stay valid, until purge() is called. Stale
+                    Handles are ignored.
+ ******************************************************************************/
+void Room::remove(Handle h)
+{
+    if(world.lookup(h))
+        doomed.push_back(h);
+}
+
+template <class T>
+static void sweep(vector<T*>& v, vector<Object*>& dead)
+{
+    int kept = 0;
+
+    for(int i = 0; i < (int)v.size(); i++)
+    {
+        if(!binary_search(dead.begin(), dead.end(), (Object*)v[i]))
+            v[kept++] = v[i];
+    }
+    v.resize(kept);
+}
+
+/*******************************************************************************
+ Name:              purge
+ Description:       Destroys the objects marked by remove(). Each leaves the
+                    object list by swapping in the last object, so the list
+                    is never shifted; the registries are compacted in one
+                    pass each and keep their order, which the engines rely
+                    on to give the same results every run.
+ ******************************************************************************/
+void Room::purge()
+{
+    if(doomed.empty())
+        return;
+
+    vector<Object*> dead;
+
+    for(int k = 0; k < (int)doomed.size(); k++)
+    {
+        Object* obj = world.lookup(doomed[k]);
+
+        //marked twice
+        if(!obj)
+            continue;
+
+        int     i    = where[doomed[k].index];
+        Object* last = object.back();
+
+        object[i] = last;
+        where[last->getHandle().index] = i;
+        object.pop_back();
+
+        world.untrack(doomed[k]);
+        dead.push_back(obj);
+    }
+    doomed.clear();
+
+    sort(dead.begin(), dead.end());
+
+    int kept = 0;
+    for(int i = 0; i < (int)drawables.size(); i++)
+    {
+        if(!binary_search(dead.begin(), dead.end(), (Object*)drawables[i].obj))
+            drawables[kept++] = drawables[i];
+    }
+    drawables.resize(kept);
+    queue.sweep(dead);
+
+    int numBodies = (int)bodies.size();
+    sweep(bodies, dead);
+    world.bodiesRemoved += numBodies - (int)bodies.size();
+    sweep(mechanics, dead);
+    sweep(controllables, dead);
+    sweep(audibles, dead);
+
+    for(int i = 0; i < (int)dead.size(); i++)
+        destroy(dead[i]);
+}
+
+/*******************************************************************************
+ Name:              destroy
+ Description:       Runs an object's destructor, and gives its memory back
+                    unless it is in the arena, which is freed all at once
+ ******************************************************************************/
+void Room::destroy(Object* obj)
 {
-    delete object[i];
-    object.erase(object.begin()+i);
+    if(arena.owns(obj))
+        obj->~Object();
+    else
+        delete obj;
 }
 
 void Room::setBackground(char* file)
 {
-    SDL_FreeSurface(background);
-    background = SDL_LoadBMP(file);
+    TextureCache::release(background);
+    background = TextureCache::acquire(file, false);
 }
 
 void Room::erase()
 {
-    while(!object.empty())
+    world.bodiesRemoved += (int)bodies.size();
+
+    drawables.clear();
+    queue.clear();
+    bodies.clear();
+    mechanics.clear();
+    controllables.clear();
+    audibles.clear();
+
+    doomed.clear();
+
+    for(int i = 0; i < (int)object.size(); i++)
     {
-        delete object[0];
-        object.erase(object.begin());
+        world.untrack(object[i]->getHandle());
+        destroy(object[i]);
     }
+
+    object.clear();
+    arena.reset();
 }
 
 SDL_Surface* Room::getBackground()
@@ -72,6 +183,24 @@ SDL_Surface* Room::getBackground()
     return background;
 }
 
+/*******************************************************************************
+ Name:              clampField
+ Description:       A field size from a level file, kept between the
+                    screen's and the largest SDL_Rect coordinate
+
+ Input:
+    n               Size the level asks for
+    screen          The screen's size along the same axis
+ ******************************************************************************/
+static int clampField(int n, int screen)
+{
+    if(n < screen)
+        return screen;
+    if(n > World::MAX_FIELD)
+        return World::MAX_FIELD;
+    return n;
+}
+
 /*******************************************************************************
  Name:              load
  Description:       This method dynamically allocates and loads objects in the
@@ -104,6 +233,12 @@ bool Room::load(const char* f)
         inFile >> backgroundFile;
         inFile >> roomType;
         inFile >> numObjects;
+
+        //the screen's size unless a Field line says
+        world.fieldW = World::FIELD_W;
+        world.fieldH = World::FIELD_H;
+        world.camera.reset();
+
         for(int i = 0; i < numObjects; i++)
         {
             inFile >> dataType;
@@ -114,7 +249,7 @@ bool Room::load(const char* f)
                     string file, birds;
                     int x, y;
                     inFile >> file >> x >> y >> birds;
-                    object.push_back(new Sling(file.c_str(), x, y, birds.c_str()));
+                    add(new (arena) Sling(file.c_str(), x, y, birds.c_str()));
                     break;
                 }
                 case 2://Pig
@@ -122,7 +257,7 @@ bool Room::load(const char* f)
                     string file;
                     int x, y, xvel, yvel;
                     inFile >> file >> x >> y >> xvel >> yvel;
-                    object.push_back(new Pig(file.c_str(),  x, y, xvel, yvel));
+                    add(new (arena) Pig(file.c_str(),  x, y, xvel, yvel));
                     break;
                 }
                 case 3://Wall
@@ -130,7 +265,7 @@ bool Room::load(const char* f)
                     string file;
                     int x, y, xvel, yvel, w, h;
                     inFile >> file >> x >> y >> xvel >> yvel >> w >> h;
-                    object.push_back(new Wall(file.c_str(), x, y, xvel, yvel, w, h));
+                    add(new (arena) Wall(file.c_str(), x, y, xvel, yvel, w, h));
                     break;
                 }
                 case 4://ClickableObject
@@ -138,7 +273,7 @@ bool Room::load(const char* f)
                     string file;
                     int x, y, w, h, v;
                     inFile >> file >> x >> y >> w >> h >> v;
-                    object.push_back(new ClickableObject(file.c_str(), x, y, w, h, v));
+                    add(new (arena) ClickableObject(file.c_str(), x, y, w, h, v));
                     break;
                 }
                 case 5://MenuItem
@@ -146,7 +281,7 @@ bool Room::load(const char* f)
                     string file;
                     int x, y, w, h, v;
                     inFile >> file >> x >> y >> w >> h >> v;
-                    object.push_back(new MenuItem(file.c_str(), x, y, w, h, v));
+                    add(new (arena) MenuItem(file.c_str(), x, y, w, h, v));
                     break;
                 }
                 case 6://NonInteractionObject
@@ -154,7 +289,7 @@ bool Room::load(const char* f)
                     string file;
                     int x, y;
                     inFile >> file >> x >> y;
-                    object.push_back(new NonInteractionObject(file.c_str(), x, y));
+                    add(new (arena) NonInteractionObject(file.c_str(), x, y));
                     break;
                 }
                 case 7://DestructableWall
@@ -162,15 +297,37 @@ bool Room::load(const char* f)
                     string file;
                     int x, y, xvel, yvel, w, h;
                     inFile >> file >> x >> y >> xvel >> yvel >> w >> h;
-                    object.push_back(new DestructableWall(file.c_str(), x, y, xvel, yvel, w, h));
+                    add(new (arena) DestructableWall(file.c_str(), x, y, xvel, yvel, w, h));
+                    break;
+                }
+                case 8://Field size, for levels bigger than the screen
+                {
+                    int w = World::FIELD_W;
+                    int h = World::FIELD_H;
+                    inFile >> w >> h;
+
+                    //no smaller than the screen, and no bigger than a rect
+                    //can reach
+                    world.fieldW = clampField(w, World::FIELD_W);
+                    world.fieldH = clampField(h, World::FIELD_H);
                     break;
                 }
             }
         }
 
-        background = SDL_LoadBMP(backgroundFile.c_str());
+        world.camera.settle(world);
+
+        if(!Object::isHeadless())
+        {
+            TextureCache::release(background);
+            background = TextureCache::acquire(backgroundFile.c_str(), false);
+        }
+
+        //images the old level used and this one does not
+        TextureCache::trim();
         
-        MechanicsObject::resetScore();
+        world.score  = 0;
+        world.paused = false;
 
         loaded = true;
     }
@@ -178,11 +335,60 @@ bool Room::load(const char* f)
     return loaded;
 }
 
-void Room::add(Object* obj)
+/*******************************************************************************
+ Name:              add
+ Description:       Puts an object in the room and in the room's World
+
+ Input:
+    obj             The object, now owned by the room
+
+ Output:
+    returns         The object's Handle, good until the room destroys it
+ ******************************************************************************/
+Handle Room::add(Object* obj)
 {
+    Handle h = world.track(obj);
+
+    obj->setHandle(h);
+    obj->setWorld(&world);
+
+    if(h.index >= (int)where.size())
+        where.resize(h.index + 1);
+    where[h.index] = (int)object.size();
+
     object.push_back(obj);
+    list(obj);
+
+    return h;
 }
 
+/*******************************************************************************
+ Name:              list
+ Description:       Adds an object to the registry of each thing it can do.
+                    This is the only place the object is cast, so the engines
+                    walk their own registry without any RTTI.
+ ******************************************************************************/
+void Room::list(Object* obj)
+{
+    if(obj->isDrawable())
+    {
+        DrawEntry e;
+        e.obj  = dynamic_cast<DrawableObject*>(obj);
+        e.body = obj->isPhysical() ? dynamic_cast<PhysicalObject*>(obj) : NULL;
+        drawables.push_back(e);
+        queue.insert(e);
+    }
+    if(obj->isPhysical())
+        bodies.push_back(dynamic_cast<PhysicalObject*>(obj));
+    if(obj->isMechanical())
+        mechanics.push_back(dynamic_cast<MechanicsObject*>(obj));
+    if(obj->isControllable())
+        controllables.push_back(dynamic_cast<ControllableObject*>(obj));
+    if(obj->isAudible())
+        audibles.push_back(dynamic_cast<AudibleObject*>(obj));
+}
+
+
 //Not really sure that we actually want this as a bool
 bool Room::pause()
 {
@@ -193,6 +399,8 @@ bool Room::pause()
         obj = getObjectAt(i);
         (obj)->pause();
     }
+    queue.rebuild(drawables);
+    world.paused = true;
     return true;
 }
 
@@ -206,5 +414,7 @@ bool Room::unpause()
         obj = getObjectAt(i);
         (obj)->unpause();
     }
+    queue.rebuild(drawables);
+    world.paused = false;
     return true;
 }
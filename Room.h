@@ -13,7 +13,16 @@
 #include <string>
 #include <SDL/SDL.h>
 
+#include "World.h"
+#include "Arena.h"
+#include "RenderQueue.h"
+
 class Object;
+class DrawableObject;
+class PhysicalObject;
+class MechanicsObject;
+class ControllableObject;
+class AudibleObject;
 
 using namespace std;
 
@@ -25,6 +34,21 @@ class Room
         vector<Object*>     object;
         int                 roomType;
         SDL_Surface*        background;
+        World               world;
+        Arena               arena;      //the objects load() builds
+        vector<Handle>      doomed;     //objects remove() was given
+        vector<int>         where;      //place in object of each Handle slot
+
+        //every object again, by capability, in the order they were added
+        vector<DrawEntry>           drawables;
+        vector<PhysicalObject*>     bodies;
+        vector<MechanicsObject*>    mechanics;
+        vector<ControllableObject*> controllables;
+        vector<AudibleObject*>      audibles;
+        RenderQueue                 queue;      //drawables showing, by layer
+
+        void                list(Object* obj);
+        void                destroy(Object* obj);
 
     public:
         Room();
@@ -35,16 +59,28 @@ class Room
         Object*             getObjectAt(int);
         int                 getNumObjects();
 
+        vector<DrawEntry>&              getDrawables() {return drawables;}
+        vector<PhysicalObject*>&        getBodies() {return bodies;}
+        vector<MechanicsObject*>&       getMechanics() {return mechanics;}
+        vector<ControllableObject*>&    getControllables() {return controllables;}
+        vector<AudibleObject*>&         getAudibles() {return audibles;}
+        RenderQueue&                    getRenderQueue() {return queue;}
+
         bool                load(const char* f);
-        void                add(Object*);
-        void                remove(int i);
+        Handle              add(Object*);
+        void                remove(Handle h);
+        Object*             get(Handle h) {return world.lookup(h);}
+        void                purge();
         void                erase();
         void                setRoomType(int r) {roomType = r;}
         int                 getRoomType() {return roomType;}
         void                setBackground(char* file);
         SDL_Surface*        getBackground();
+        World&              getWorld() {return world;}
+        Camera&             getCamera() {return world.camera;}
         bool                pause();
         bool                unpause();
+        bool                isPaused() {return world.paused;}
 };
 
 #endif
@@ -0,0 +1,206 @@
+/*******************************************************************************
+ Filename:                  Simulation.cpp
+ Classname:                 Simulation
+
+ Description:               This file defines the Simulation class. A
+                            Simulation plays a level without a screen, sound
+                            or mouse: it loads a .gel file, fires birds from
+                            the Sling with given velocities, and steps the
+                            mechanics and physics until everything is at rest.
+                            It is the game loop of Game::run minus the
+                            graphics, control and audio engines.
+ ******************************************************************************/
+
+#include "Simulation.h"
+
+const int DEFAULT_MAX_TICKS = 2400;     //per shot, 20 seconds at 120 Hz
+
+/*******************************************************************************
+ Name:              Simulation
+ Description:       Constructor. Switches objects to headless loading, so no
+                    images, fonts or sounds are read.
+
+ Input:
+    threads         Threads the PhysicsEngine solves islands on; batch runs
+                    are better off running one Simulation per core
+ ******************************************************************************/
+Simulation::Simulation(int threads)
+    :   phys(threads)
+{
+    //only written once, Simulations may be built on several threads
+    if(!Object::isHeadless())
+        Object::setHeadless(true);
+
+    sling     = NULL;
+    ticks     = 0;
+    startPigs = 0;
+    birdsUsed = 0;
+    maxTicks  = DEFAULT_MAX_TICKS;
+}
+
+/*******************************************************************************
+ Name:              load
+ Description:       Loads a level and lets it settle, as it would while the
+                    player lines up the first shot
+
+ Input:
+    level           The .gel file
+
+ Output:
+    returns         false if the file could not be read
+ ******************************************************************************/
+bool Simulation::load(const char* level)
+{
+    sling     = NULL;
+    ticks     = 0;
+    birdsUsed = 0;
+
+    if(!room.load(level))
+        return false;
+
+    for(int i = 0; i < room.getNumObjects() && !sling; i++)
+        sling = dynamic_cast<Sling*>(room.getObjectAt(i));
+
+    startPigs = room.getWorld().numPigs;
+
+    stepToRest();
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              launch
+ Description:       Fires the next bird in the sling
+
+ Input:
+    v               Launch velocity in pixels per tick
+
+ Output:
+    returns         false if the level has no sling or no birds left
+ ******************************************************************************/
+bool Simulation::launch(Vect v)
+{
+    if(!sling)
+        return false;
+
+    Projectile* bird = sling->launch(v);
+
+    if(!bird)
+        return false;
+
+    sling->adopt(room.add(bird));
+    birdsUsed++;
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              removeDead
+ Description:       Deletes the objects that finished last tick, as
+                    StateEngine::run does between frames
+ ******************************************************************************/
+void Simulation::removeDead()
+{
+    for(int i = 0; i < room.getNumObjects(); i++)
+    {
+        if(room.getObjectAt(i)->getState() == -1)
+            room.remove(room.getObjectAt(i)->getHandle());
+    }
+    room.purge();
+}
+
+/*******************************************************************************
+ Name:              step
+ Description:       Advances one fixed tick
+ ******************************************************************************/
+void Simulation::step()
+{
+    removeDead();
+    mech.run(room);
+    phys.run(room);
+    ticks++;
+}
+
+/*******************************************************************************
+ Name:              atRest
+ Description:       True once every body has gone to sleep, or the level is
+                    won
+ ******************************************************************************/
+bool Simulation::atRest()
+{
+    return phys.getNumAwake() == 0 || room.getWorld().numPigs <= 0;
+}
+
+/*******************************************************************************
+ Name:              stepToRest
+ Description:       Steps until atRest, giving up after maxTicks
+
+ Output:
+    returns         Ticks stepped
+ ******************************************************************************/
+int Simulation::stepToRest()
+{
+    int n = 0;
+
+    do
+    {
+        step();
+        n++;
+    }
+    while(!atRest() && n < maxTicks);
+
+    removeDead();
+
+    return n;
+}
+
+/*******************************************************************************
+ Name:              getResult
+ Description:       The outcome so far
+ ******************************************************************************/
+SimResult Simulation::getResult()
+{
+    SimResult r;
+
+    r.pigsLeft   = room.getWorld().numPigs;
+    r.pigsKilled = startPigs - r.pigsLeft;
+    r.birdsUsed  = birdsUsed;
+    r.score      = room.getWorld().score;
+    r.ticks      = ticks;
+    r.won        = r.pigsLeft <= 0;
+
+    return r;
+}
+
+/*******************************************************************************
+ Name:              run
+ Description:       Plays a whole level: loads it, then fires each launch in
+                    turn once the last has come to rest. Stops early when the
+                    level is won or the sling is empty.
+
+ Input:
+    level           The .gel file
+    launches        Launch velocities, in firing order
+
+ Output:
+    returns         The outcome; ticks is -1 if the level did not load
+ ******************************************************************************/
+SimResult Simulation::run(const char* level, const vector<Vect>& launches)
+{
+    if(!load(level))
+    {
+        SimResult r = getResult();
+        r.ticks = -1;
+        return r;
+    }
+
+    for(int i = 0; i < (int)launches.size(); i++)
+    {
+        if(room.getWorld().numPigs <= 0 || !launch(launches[i]))
+            break;
+
+        stepToRest();
+    }
+
+    return getResult();
+}
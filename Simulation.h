@@ -0,0 +1,70 @@
+/*******************************************************************************
+ Filename:                  Simulation.h
+ Classname:                 Simulation
+
+ Description:               This file declares the Simulation class. A
+                            Simulation plays a level without a screen, sound
+                            or mouse: it loads a .gel file, fires birds from
+                            the Sling with given velocities, and steps the
+                            mechanics and physics until everything is at rest.
+                            It is the game loop of Game::run minus the
+                            graphics, control and audio engines.
+ ******************************************************************************/
+
+#ifndef AngrySomething_Simulation_h
+#define AngrySomething_Simulation_h
+
+#include <vector>
+
+#include "Room.h"
+#include "PhysicsEngine.h"
+#include "MechanicsEngine.h"
+#include "Sling.h"
+#include "Geometry.h"
+
+using namespace std;
+
+struct SimResult
+{
+    int     pigsKilled;
+    int     pigsLeft;
+    int     birdsUsed;
+    int     score;
+    int     ticks;
+    bool    won;
+};
+
+class Simulation
+{
+    private:
+        Room            room;
+        PhysicsEngine   phys;
+        MechanicsEngine mech;
+        Sling*          sling;
+        int             ticks;
+        int             startPigs;
+        int             birdsUsed;
+        int             maxTicks;
+
+        void    removeDead();
+
+    public:
+        Simulation(int threads = 1);
+
+        bool        load(const char* level);
+        bool        launch(Vect v);
+        void        step();
+        bool        atRest();
+        int         stepToRest();
+
+        SimResult   getResult();
+        SimResult   run(const char* level, const vector<Vect>& launches);
+
+        void        setMaxTicks(int t) {if(t > 0) maxTicks = t;}
+        int         getMaxTicks() {return maxTicks;}
+        int         getTicks() {return ticks;}
+        int         getBirdsLeft() {return room.getWorld().slingBirds;}
+        Room&       getRoom() {return room;}
+};
+
+#endif
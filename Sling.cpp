@@ -11,6 +11,13 @@
 #include <cmath>
 
 #include "Sling.h"
+#include "World.h"
+#include "TextureCache.h"
+#include "TextCache.h"
+
+//where the score is drawn, on the screen
+const int SCORE_X = 1100;
+const int SCORE_Y = 30;
 
 /*******************************************************************************
  Name:              Sling
@@ -20,9 +27,6 @@
     file            The image filename
     x, y            The x and y coordinates of the object
  ******************************************************************************/
-
-int Sling::projectileCount = 0;
-
 Sling::Sling(const char* file, int x, int y, string ammo)
     :   Object(x, y, 180, 150),
         DrawableObject(file, 2),
@@ -30,14 +34,18 @@ Sling::Sling(const char* file, int x, int y, string ammo)
 {
     grabbed = false;
 
-    launcherImg = SDL_LoadBMP("Slingshot.bmp");
+    launcherImg.surface = NULL;
+
+    if(!isHeadless())
+        launcherImg = TextureCache::acquireSprite("Slingshot.bmp");
 
     Slingshot.x = x - 25;
     Slingshot.y = y;
 
     radius = 75;
 
-    monk = NULL;
+    loaded = NULL;
+    shownScore = 0;
 
     projectiles = ammo;
     projectileCount = (int)projectiles.length();
@@ -60,7 +68,65 @@ Sling::Sling(const char* file, int x, int y, string ammo)
  ******************************************************************************/
 Sling::~Sling()
 {
-    SDL_FreeSurface(launcherImg);
+    if(world)
+        world->slingBirds -= projectileCount;
+    TextureCache::release(launcherImg.surface);
+    delete loaded;
+}
+
+/*******************************************************************************
+ Name:              setWorld
+ Description:       Counts the birds left in the sling in the world it joins,
+                    for the lose check, and makes itself home for the
+                    world's camera
+ ******************************************************************************/
+void Sling::setWorld(World* w)
+{
+    if(world)
+        world->slingBirds -= projectileCount;
+
+    Object::setWorld(w);
+
+    if(world)
+    {
+        world->slingBirds += projectileCount;
+        world->camera.setHome(pos);
+    }
+}
+
+/*******************************************************************************
+ Name:              scoreLoc
+ Description:       Where the score goes: at SCORE_X, SCORE_Y on the screen,
+                    wherever the camera is in the field
+ ******************************************************************************/
+SDL_Rect Sling::scoreLoc()
+{
+    SDL_Rect r;
+
+    r.x = SCORE_X;
+    r.y = SCORE_Y;
+    r.w = message ? message->w : 0;
+    r.h = message ? message->h : 0;
+
+    if(world)
+    {
+        SDL_Rect view = world->camera.getShown();
+        r.x += view.x;
+        r.y += view.y;
+    }
+
+    return r;
+}
+
+/*******************************************************************************
+ Name:              useBird
+ Description:       One bird fewer in the sling
+ ******************************************************************************/
+void Sling::useBird()
+{
+    projectileCount--;
+    if(world)
+        world->slingBirds--;
 }
 
 /*******************************************************************************
@@ -113,9 +179,6 @@ Projectile* Sling::createMonkey(char type, int xPos, int yPos, int xVel, int yVe
  ******************************************************************************/
 void Sling::handle(SDL_Event e)
 {
-    monk = NULL;
-    static bool grabbed = false;
-
     if(checkBounds(e))
     {
         if(e.type == SDL_MOUSEMOTION && grabbed)
@@ -141,8 +204,8 @@ void Sling::handle(SDL_Event e)
             {
                 if(projectileCount > 0)
                 {
-                    monk = createMonkey(projectiles[projectileCount - 1], pos.x, pos.y, (centerX - pos.x)*.2, (centerY - pos.y)*.2);
-                    projectileCount--;
+                    loaded = createMonkey(projectiles[projectileCount - 1], pos.x, pos.y, (centerX - pos.x)*.2, (centerY - pos.y)*.2);
+                    useBird();
                 }
 
                 pos.x = centerX;
@@ -173,10 +236,10 @@ void Sling::handle(SDL_Event e)
             {
                 if(projectileCount > 0)
                 {
-                    monk = createMonkey(projectiles[projectileCount - 1], pos.x, pos.y, (centerX - pos.x)*.5, (centerY - pos.y)*.4);
+                    loaded = createMonkey(projectiles[projectileCount - 1], pos.x, pos.y, (centerX - pos.x)*.5, (centerY - pos.y)*.4);
                 }
 
-                projectileCount--;
+                useBird();
 
                 pos.x = centerX;
                 pos.y = centerY;
@@ -196,31 +259,108 @@ void Sling::handle(SDL_Event e)
  ******************************************************************************/
 void Sling::draw(SDL_Surface* s)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect loc = pos;
+    SDL_Rect launcherLoc = Slingshot;
 
-    SDL_BlitSurface(launcherImg, NULL, s, &Slingshot);
-    SDL_BlitSurface(image, NULL, s, &loc);
-    
-    char buffer[10];
-    sprintf(buffer,"%d",getScore());
-    
-    message = TTF_RenderText_Solid(font, buffer, fontColor);
-    
-    static SDL_Rect scoreLoc;
-    scoreLoc.x = 1100;
-    scoreLoc.y = 30;
+    Blitter::blit(launcherImg.surface, &launcherImg.rect, s, &launcherLoc);
+    Blitter::blit(image, &frame, s, &loc);
     
-    SDL_BlitSurface(message, NULL, s, &scoreLoc);
+    SDL_Rect score = scoreLoc();
+
+    Blitter::blit(message, NULL, s, &score);
 }
 
+/*******************************************************************************
+ Name:              prepare
+ Description:       Renders the score, only when it has changed
+ ******************************************************************************/
+void Sling::prepare()
+{
+    if(message == NULL || getScore() != shownScore)
+    {
+        char buffer[12];
+        sprintf(buffer,"%d",getScore());
+
+        TextCache::release(message);
+        message    = TextCache::acquire(font, buffer, fontColor);
+        shownScore = getScore();
+        changed    = true;
+    }
+}
+
+/*******************************************************************************
+ Name:              getBounds
+ Description:       The sling, the bird in it, and the score
+ ******************************************************************************/
+SDL_Rect Sling::getBounds()
+{
+    SDL_Rect r = imageBounds();
+
+    if(launcherImg.surface)
+    {
+        SDL_Rect l = Slingshot;
+        l.w = launcherImg.rect.w;
+        l.h = launcherImg.rect.h;
+        r = unite(r, l);
+    }
+
+    if(message)
+        r = unite(r, scoreLoc());
+
+    return r;
+}
+
+/*******************************************************************************
+ Name:              launch
+ Description:       Fires the next bird from the rest position of the sling,
+                    without mouse input; used by headless simulations
+
+ Input:
+    v               Launch velocity
+
+ Output:
+    returns         The bird, to be added to the room, or NULL when there
+                    are none left
+ ******************************************************************************/
+Projectile* Sling::launch(Vect v)
+{
+    if(projectileCount <= 0)
+        return NULL;
+
+    Projectile* p = createMonkey(projectiles[projectileCount - 1], centerX, centerY, (int)v.x, (int)v.y);
+    useBird();
+
+    return p;
+}
+
+/*******************************************************************************
+ Name:              process
+ Description:       Hands the bird just fired to the room
+
+ Output:
+    returns         The bird, or NULL
+ ******************************************************************************/
 Object* Sling::process()
 {
-    Projectile* m = monk;
-    monk = NULL;
+    Projectile* m = loaded;
+    loaded = NULL;
     return m;
 }
 
+/*******************************************************************************
+ Name:              adopt
+ Description:       Remembers the Handle of the bird in flight, and has the
+                    camera follow it. It looks up as NULL once the bird is
+                    gone, and the camera comes back to the sling.
+ ******************************************************************************/
+void Sling::adopt(Handle h)
+{
+    monk = h;
+
+    if(world)
+        world->camera.follow(getMonk());
+}
+
 void Sling::pause()
 {
     activeDraw = true;
@@ -29,14 +29,19 @@ class Sling : public DrawableObject, public MechanicsObject, public Controllable
         bool            checkBounds(SDL_Event);
         bool            grabbed;
         bool            fired;
-        Projectile*     monk;
+        Projectile*     loaded;     //fired, not yet handed to the room
+        Handle          monk;       //the bird in flight
         Projectile*     createMonkey(char type, int, int, int, int);
+        void            useBird();
         SDL_Rect        Slingshot;
         string          projectiles;
-        static int      projectileCount;
-        SDL_Surface*    launcherImg;
+        int             projectileCount;
+        Sprite          launcherImg;
         int             centerX;
         int             centerY;
+        int             shownScore;     //the score message holds
+
+        SDL_Rect        scoreLoc();
 
     public:
         Sling(const char* file1, int x, int y, string ammo);
@@ -44,9 +49,15 @@ class Sling : public DrawableObject, public MechanicsObject, public Controllable
 
         void        handle(SDL_Event);
         Object*     process();
+        void        adopt(Handle h);
+        Projectile* launch(Vect v);
+        void        prepare();
         void        draw(SDL_Surface*);
+        SDL_Rect    getBounds();
 
-        static int  getProjectileCount(){ return projectileCount;}
+        int         getProjectileCount(){ return projectileCount;}
+        Handle      getMonk() {return monk;}
+        void        setWorld(World* w);
         void        pause();
         void        unpause();
 };
@@ -1,197 +1,270 @@
 #include "StateEngine.h"
+#include "Prefetcher.h"
+#include "ClickableObject.h"
+#include "LoadingSign.h"
+
+#include <algorithm>
+
+StateEngine::StateEngine()
+{
+    loader = NULL;
+    pendingLevel = 0;
+}
 
 bool StateEngine::run(Room& room)
 {
-    static int currentLevel = 0;
+    World& world = room.getWorld();
     int state = 0;
     bool running = true;
     //Object* obj;
 
+    //A level was picked before its images were decoded. The screen it was
+    //picked from stays up, with a LoadingSign over it, and still takes
+    //clicks until they are.
+    if(!pending.empty() && loader->isReady(pending))
+    {
+        string file = pending;
+        stopLoading(room);
+        return pick(room, file.c_str(), pendingLevel);
+    }
+
     for(int i = 0; i < room.getNumObjects() && !state; i++)
     {
         state = room.getObjectAt(i)->check();
         if(room.getObjectAt(i)->getState() == -1)
-            room.remove(i--);
+            room.remove(room.getObjectAt(i)->getHandle());
     }
+    room.purge();
 
     //If the room is a level
     if(room.getRoomType() == 1)
     {
-        if(Pig::getNumPigs() <= 0)
+        if(world.numPigs <= 0)
         {
             //Win Condition
             state = -2;
         }
 
-        if(Projectile::getNumBirds() <= 0 && Sling::getProjectileCount() <= 0)
+        if(world.numBirds <= 0 && world.slingBirds <= 0)
         {
             //Lose Condition
             state = -1;
         }
     }
 
+    //anything chosen meanwhile replaces the level still loading
+    if(state != 0 && !pending.empty())
+        stopLoading(room);
+
     if(state == -2)
-            currentLevel++;
-//    static bool paused = false;
+            world.level++;
     switch(state)
     {
         //Pause/Unpause the game
         case -6:
-            static bool paused = false;
-            if(paused)
+            if(room.isPaused())
             {
                 running = room.unpause();
-                paused = false;
             }
             else
             {
                 running = room.pause();
-                paused = true;
             }
             break;
         //Reset the level
         case -5:
-            if(!room.load(decideLevel(currentLevel).c_str()))
-                running = room.load("TitleScreen.gel");
-            paused = false;
+            if(!enter(room, decideLevel(world.level).c_str()))
+                running = enter(room, "TitleScreen.gel");
             break;
         //TitleScreen
         case -4:
-            running = room.load("TitleScreen.gel");
-            paused = false;
+            running = enter(room, "TitleScreen.gel");
             break;
         //Level Select
         case -3:
-            running = room.load("LevelSelect.gel");
-            paused = false;
+            running = enter(room, "LevelSelect.gel");
             break;
         //You beat the previous level, move to the title screen
         case -2:
-            //if(!room.load(decideLevel(currentLevel).c_str()))
-                running = room.load("TitleScreen.gel");
-            paused = false;
+            //if(!room.load(decideLevel(world.level).c_str()))
+                running = enter(room, "TitleScreen.gel");
             break;
         // You Lose. Exit the program
         case -1:
             running = false;
-            paused = false;
             break;
         // Load whichever level you like
         case 1:
-            running = room.load("Cordona.gel");
-            currentLevel = 1;
-            paused = false;
+            running = pick(room, "Cordona.gel", 1);
             break;
         case 11:
-            running = room.load("Cordona1.gel");
-            currentLevel = 11;
-            paused = false;
+            running = pick(room, "Cordona1.gel", 11);
             break;
         case 12:
-            running = room.load("Cordona2.gel");
-            currentLevel = 12;
-            paused = false;
+            running = pick(room, "Cordona2.gel", 12);
             break;
         case 13:
-            running = room.load("Cordona3.gel");
-            currentLevel = 13;
-            paused = false;
+            running = pick(room, "Cordona3.gel", 13);
             break;
         case 2:
-            running = room.load("Apathos.gel");
-            currentLevel = 2;
-            paused = false;
+            running = pick(room, "Apathos.gel", 2);
             break;
         case 21:
-            running = room.load("Apathos1.gel");
-            currentLevel = 21;
-            paused = false;
+            running = pick(room, "Apathos1.gel", 21);
             break;
         case 22:
-            running = room.load("Apathos2.gel");
-            currentLevel = 22;
-            paused = false;
+            running = pick(room, "Apathos2.gel", 22);
             break;
         case 23:
-            running = room.load("Apathos3.gel");
-            currentLevel = 23;
-            paused = false;
+            running = pick(room, "Apathos3.gel", 23);
             break;
         case 3:
-            running = room.load("Clavus.gel");
-            currentLevel = 3;
-            paused = false;
+            running = pick(room, "Clavus.gel", 3);
             break;
         case 31:
-            running = room.load("Clavus1.gel");
-            currentLevel = 31;
-            paused = false;
+            running = pick(room, "Clavus1.gel", 31);
             break;
         case 32:
-            running = room.load("Clavus2.gel");
-            currentLevel = 32;
-            paused = false;
+            running = pick(room, "Clavus2.gel", 32);
             break;
         case 33:
-            running = room.load("Clavus3.gel");
-            currentLevel = 33;
-            paused = false;
+            running = pick(room, "Clavus3.gel", 33);
             break;
         case 4:
-            running = room.load("Knoxen.gel");
-            currentLevel = 4;
-            paused = false;
+            running = pick(room, "Knoxen.gel", 4);
             break;
         case 41:
-            running = room.load("Knoxen1.gel");
-            currentLevel = 41;
-            paused = false;
+            running = pick(room, "Knoxen1.gel", 41);
             break;
         case 42:
-            running = room.load("Knoxen2.gel");
-            currentLevel = 42;
-            paused = false;
+            running = pick(room, "Knoxen2.gel", 42);
             break;
         case 43:
-            running = room.load("Knoxen3.gel");
-            currentLevel = 43;
-            paused = false;
+            running = pick(room, "Knoxen3.gel", 43);
             break;
         case 5:
-            running = room.load("Darthon.gel");
-            currentLevel = 5;
-            paused = false;
+            running = pick(room, "Darthon.gel", 5);
             break;
         case 51:
-            running = room.load("Darthon1.gel");
-            currentLevel = 51;
-            paused = false;
+            running = pick(room, "Darthon1.gel", 51);
             break;
         case 52:
-            running = room.load("Darthon2.gel");
-            currentLevel = 52;
-            paused = false;
+            running = pick(room, "Darthon2.gel", 52);
             break;
         case 53:
-            running = room.load("Darthon3.gel");
-            currentLevel = 53;
-            paused = false;
+            running = pick(room, "Darthon3.gel", 53);
             break;
         case 6:
-            running = room.load("Ziggurat.gel");
-            currentLevel = 6;
-            paused = false;
+            running = pick(room, "Ziggurat.gel", 6);
             break;
         case 61:
-            running = room.load("Ziggurat1.gel");
-            currentLevel = 61;
-            paused = false;
+            running = pick(room, "Ziggurat1.gel", 61);
             break;
     }
 
     return running;
 }
 
+/*******************************************************************************
+ Name:              enter
+ Description:       Loads a room and starts prefetching the rooms that can
+                    be picked from it
+
+ Output:
+    returns         false if the room could not be loaded
+ ******************************************************************************/
+bool StateEngine::enter(Room& room, const char* file)
+{
+    if(!room.load(file))
+        return false;
+
+    prefetchFrom(room);
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              pick
+ Description:       Loads a level, unless the Prefetcher is still decoding
+                    its images; then they are moved to the front of its queue
+                    and run() loads the level once they are ready
+
+ Input:
+    file            The level's .gel
+    level           Its number, for decideLevel
+
+ Output:
+    returns         false if the level could not be loaded
+ ******************************************************************************/
+bool StateEngine::pick(Room& room, const char* file, int level)
+{
+    if(loader && loader->isRunning() && !loader->isReady(file))
+    {
+        loader->hurry(file);
+        pending      = file;
+        pendingLevel = level;
+        sign         = room.add(new LoadingSign());
+        return true;
+    }
+
+    bool loaded = enter(room, file);
+    room.getWorld().level = level;
+
+    return loaded;
+}
+
+/*******************************************************************************
+ Name:              stopLoading
+ Description:       Gives up waiting for the level picked last, and takes
+                    its LoadingSign down
+ ******************************************************************************/
+void StateEngine::stopLoading(Room& room)
+{
+    pending.clear();
+    room.remove(sign);
+    sign = Handle();
+}
+
+/*******************************************************************************
+ Name:              prefetchFrom
+ Description:       Hands the Prefetcher the rooms the buttons of this one
+                    lead to; from a level, only the title screen, where
+                    winning and quitting both go
+ ******************************************************************************/
+void StateEngine::prefetchFrom(Room& room)
+{
+    if(!loader)
+        return;
+
+    vector<string> next;
+
+    if(room.getRoomType() == Level)
+        next.push_back("TitleScreen.gel");
+
+    for(int i = 0; i < room.getNumObjects(); i++)
+    {
+        ClickableObject* button = dynamic_cast<ClickableObject*>(room.getObjectAt(i));
+
+        if(!button)
+            continue;
+
+        int    v = button->getValue();
+        string file;
+
+        if(v > 0)
+            file = decideLevel(v);
+        else if(v == -3)
+            file = "LevelSelect.gel";
+        else if(v == -4)
+            file = "TitleScreen.gel";
+
+        if(!file.empty() && find(next.begin(), next.end(), file) == next.end())
+            next.push_back(file);
+    }
+
+    loader->prefetch(next);
+}
+
 string StateEngine::decideLevel(int i)
 {
     /*
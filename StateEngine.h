@@ -8,10 +8,28 @@
 #include "Sling.h"
 #include <string>
 
+class Prefetcher;
+
 class StateEngine
 {
+    private:
+        Prefetcher* loader;
+        string      pending;        //level picked before its images were ready
+        int         pendingLevel;
+        Handle      sign;           //the LoadingSign shown meanwhile
+
+        bool    enter(Room& room, const char* file);
+        bool    pick(Room& room, const char* file, int level);
+        void    stopLoading(Room& room);
+
     public:
+        StateEngine();
+
         bool run(Room& room);
         string  decideLevel(int i);
+
+        void    setPrefetcher(Prefetcher* p) {loader = p;}
+        void    prefetchFrom(Room& room);
+        bool    isLoading() {return !pending.empty();}
 };
 #endif // STATEENGINE_H
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ Filename:                  TextCache.cpp
+ Classname:                 TextCache
+
+ Description:               This file defines the TextCache class.
+ ******************************************************************************/
+
+#include "TextCache.h"
+
+map<TextCache::Key, TextCache::Entry>   TextCache::entries;
+map<SDL_Surface*, TextCache::Key>       TextCache::owners;
+list<TextCache::Key>                    TextCache::lru;
+int                                     TextCache::hits   = 0;
+int                                     TextCache::misses = 0;
+
+/*******************************************************************************
+ Name:              acquire
+ Description:       Finds a rendered string, or renders it, and takes a
+                    reference to it
+
+ Input:
+    font            From FontManager
+    text            The string
+    color           Its color
+
+ Output:
+    returns         The shared surface, or NULL without a font
+ ******************************************************************************/
+SDL_Surface* TextCache::acquire(TTF_Font* font, const string& text, SDL_Color color)
+{
+    if(!font)
+        return NULL;
+
+    Key key;
+    key.font  = font;
+    key.text  = text;
+    key.color = (color.r << 16) | (color.g << 8) | color.b;
+
+    map<Key, Entry>::iterator it = entries.find(key);
+
+    if(it != entries.end())
+    {
+        hits++;
+        it->second.refs++;
+        lru.splice(lru.begin(), lru, it->second.age);
+        return it->second.surface;
+    }
+
+    misses++;
+
+    SDL_Surface* s = TTF_RenderText_Solid(font, text.c_str(), color);
+
+    if(!s)
+        return NULL;
+
+    //in the display format, keeping its color key, Blitter copies it directly
+    if(SDL_GetVideoSurface())
+    {
+        SDL_Surface* converted = SDL_DisplayFormat(s);
+
+        if(converted)
+        {
+            SDL_FreeSurface(s);
+            s = converted;
+        }
+    }
+
+    lru.push_front(key);
+
+    Entry e;
+    e.surface = s;
+    e.refs    = 1;
+    e.age     = lru.begin();
+
+    entries[key] = e;
+    owners[s]    = key;
+
+    evict();
+
+    return s;
+}
+
+/*******************************************************************************
+ Name:              addRef
+ Description:       Takes another reference to a surface from acquire(), for
+                    a DrawList that will draw it later
+ ******************************************************************************/
+void TextCache::addRef(SDL_Surface* s)
+{
+    map<SDL_Surface*, Key>::iterator it = owners.find(s);
+
+    if(it != owners.end())
+        entries[it->second].refs++;
+}
+
+/*******************************************************************************
+ Name:              release
+ Description:       Gives back a reference. The string stays rendered until
+                    it is among the least recently used and the cache is full.
+ ******************************************************************************/
+void TextCache::release(SDL_Surface* s)
+{
+    map<SDL_Surface*, Key>::iterator it = owners.find(s);
+
+    if(it == owners.end())
+        return;
+
+    entries[it->second].refs--;
+
+    evict();
+}
+
+/*******************************************************************************
+ Name:              evict
+ Description:       Frees the least recently used strings nobody holds until
+                    the cache is back to CAPACITY
+ ******************************************************************************/
+void TextCache::evict()
+{
+    list<Key>::iterator it = lru.end();
+
+    while((int)entries.size() > CAPACITY && it != lru.begin())
+    {
+        --it;
+
+        Entry& e = entries[*it];
+
+        if(e.refs > 0)
+            continue;
+
+        owners.erase(e.surface);
+        SDL_FreeSurface(e.surface);
+        entries.erase(*it);
+        it = lru.erase(it);
+    }
+}
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ Filename:                  TextCache.h
+ Classname:                 TextCache
+
+ Description:               This file declares the TextCache class. The
+                            TextCache keeps the surfaces TTF_RenderText_Solid
+                            has made, keyed by font, text and color, so the
+                            same string is rendered once however many frames
+                            draw it. Objects hold a rendered string with
+                            acquire() and give it back with release(); of the
+                            strings nobody holds, the least recently used are
+                            freed once there are more than CAPACITY entries.
+
+                            Surfaces from the cache are shared: never free or
+                            change one, release() it instead.
+ ******************************************************************************/
+
+#ifndef AngrySomething_TextCache_h
+#define AngrySomething_TextCache_h
+
+#include <map>
+#include <list>
+#include <string>
+#include <SDL/SDL.h>
+#include "SDL_ttf/SDL_ttf.h"
+
+using namespace std;
+
+class TextCache
+{
+    private:
+        struct Key
+        {
+            TTF_Font*   font;
+            string      text;
+            Uint32      color;
+
+            bool operator<(const Key& k) const
+            {
+                if(font != k.font)      return font < k.font;
+                if(color != k.color)    return color < k.color;
+                return text < k.text;
+            }
+        };
+
+        struct Entry
+        {
+            SDL_Surface*        surface;
+            int                 refs;
+            list<Key>::iterator age;    //place in lru
+        };
+
+        static map<Key, Entry>          entries;
+        static map<SDL_Surface*, Key>   owners;
+        static list<Key>                lru;        //most recently used first
+        static int                      hits;
+        static int                      misses;
+
+        static void         evict();
+
+    public:
+        static const int    CAPACITY = 64;
+
+        static SDL_Surface* acquire(TTF_Font* font, const string& text, SDL_Color color);
+        static void         addRef(SDL_Surface* s);
+        static void         release(SDL_Surface* s);
+
+        static int          getHits() {return hits;}
+        static int          getMisses() {return misses;}
+        static int          getNumEntries() {return (int)entries.size();}
+};
+
+#endif
@@ -0,0 +1,336 @@
+/*******************************************************************************
+ Filename:                  TextureCache.cpp
+ Classname:                 TextureCache
+
+ Description:               This file defines the TextureCache class.
+ ******************************************************************************/
+
+#include <iostream>
+#include <fstream>
+
+#include "TextureCache.h"
+#include "Prefetcher.h"
+
+//the color drawn as transparent in every sprite
+const Uint8 KEY_R = 0xFF;
+const Uint8 KEY_G = 0xAE;
+const Uint8 KEY_B = 0xC9;
+
+map<TextureCache::Key, TextureCache::Entry>     TextureCache::entries;
+map<SDL_Surface*, TextureCache::Key>            TextureCache::owners;
+int                                             TextureCache::hits     = 0;
+int                                             TextureCache::misses   = 0;
+size_t                                          TextureCache::resident = 0;
+map<string, SDL_Rect>                           TextureCache::packed;
+SDL_Surface*                                    TextureCache::atlas    = NULL;
+Archive                                         TextureCache::archive;
+Prefetcher*                                     TextureCache::prefetcher = NULL;
+
+/*******************************************************************************
+ Name:              acquire
+ Description:       Finds a loaded image, or loads it, and takes a reference
+                    to it
+
+ Input:
+    path            The .bmp file
+    keyed           Whether KEY_R, KEY_G, KEY_B is drawn as transparent
+
+ Output:
+    returns         The shared surface, or NULL if the file could not be read
+ ******************************************************************************/
+SDL_Surface* TextureCache::acquire(const char* path, bool keyed)
+{
+    Key key(path, keyed);
+    map<Key, Entry>::iterator it = entries.find(key);
+
+    if(it != entries.end())
+    {
+        hits++;
+        it->second.refs++;
+        return it->second.surface;
+    }
+
+    misses++;
+
+    SDL_Surface* s = load(path);
+
+    if(!s)
+        return NULL;
+
+    if(keyed)
+        SDL_SetColorKey(s, SDL_SRCCOLORKEY, SDL_MapRGB(s->format, KEY_R, KEY_G, KEY_B));
+
+    Entry e;
+    e.surface = s;
+    e.refs    = 1;
+    e.bytes   = (size_t)s->pitch * s->h;
+
+    entries[key] = e;
+    owners[s]    = key;
+    resident    += e.bytes;
+
+    return s;
+}
+
+/*******************************************************************************
+ Name:              decode
+ Description:       Reads an image from the archive, or else its .bmp, as it
+                    was stored. Safe to call from any thread; the Prefetcher
+                    calls it from its own.
+
+ Output:
+    returns         A new surface, or NULL if the file could not be read
+ ******************************************************************************/
+SDL_Surface* TextureCache::decode(const char* path)
+{
+    SDL_Surface* s = archive.load(path);
+
+    return s ? s : SDL_LoadBMP(path);
+}
+
+/*******************************************************************************
+ Name:              load
+ Description:       Takes an image the Prefetcher has decoded, or else
+                    decodes it, and converts it to the display format if it
+                    is not in it already
+
+ Output:
+    returns         A new surface, or NULL if the file could not be read
+ ******************************************************************************/
+SDL_Surface* TextureCache::load(const char* path)
+{
+    SDL_Surface* s = prefetcher ? prefetcher->take(path) : NULL;
+
+    if(!s)
+        s = decode(path);
+
+    if(!s)
+    {
+        cout << SDL_GetError() << endl;
+        return NULL;
+    }
+
+    //before a video mode is set there is no display format to convert to
+    SDL_Surface* video = SDL_GetVideoSurface();
+
+    if(!video)
+        return s;
+
+    SDL_PixelFormat* f = s->format;
+    SDL_PixelFormat* d = video->format;
+
+    if(f->BitsPerPixel == d->BitsPerPixel && f->Rmask == d->Rmask
+       && f->Gmask == d->Gmask && f->Bmask == d->Bmask)
+        return s;
+
+    SDL_Surface* converted = SDL_DisplayFormat(s);
+
+    if(converted)
+    {
+        SDL_FreeSurface(s);
+        s = converted;
+    }
+
+    return s;
+}
+
+/*******************************************************************************
+ Name:              acquireSprite
+ Description:       Like acquire, for a color keyed sprite: the part of the
+                    atlas it was packed into, or else the whole of its own
+                    surface. Either way release() the surface when done.
+
+ Input:
+    path            The .bmp file
+
+ Output:
+    returns         The sprite, with a NULL surface if the file could not be
+                    read
+ ******************************************************************************/
+Sprite TextureCache::acquireSprite(const char* path)
+{
+    Sprite sprite;
+    map<string, SDL_Rect>::iterator it = packed.find(path);
+
+    if(atlas && it != packed.end())
+    {
+        hits++;
+        addRef(atlas);
+        sprite.surface = atlas;
+        sprite.rect    = it->second;
+        return sprite;
+    }
+
+    sprite.surface = acquire(path);
+    sprite.rect.x  = 0;
+    sprite.rect.y  = 0;
+    sprite.rect.w  = sprite.surface ? sprite.surface->w : 0;
+    sprite.rect.h  = sprite.surface ? sprite.surface->h : 0;
+
+    return sprite;
+}
+
+/*******************************************************************************
+ Name:              loadAtlas
+ Description:       Reads an atlas table written by tools/PackAtlas.cpp and
+                    loads its image, which stays loaded for good. The table
+                    is the atlas .bmp, the number of sprites, then one line
+                    per sprite: its file, x, y, w, h in the atlas, and the
+                    size and modification time its file had when packed.
+                    A sprite whose file has changed since is left out, and
+                    loaded from its file.
+
+ Input:
+    table           The .atlas file
+
+ Output:
+    returns         false if there is no atlas to use; every sprite is then
+                    loaded from its own file
+ ******************************************************************************/
+bool TextureCache::loadAtlas(const char* table)
+{
+    ifstream inFile(table);
+
+    if(!inFile || atlas)
+        return false;
+
+    string image;
+    int    num = 0;
+
+    inFile >> image >> num;
+
+    map<string, SDL_Rect> rects;
+
+    for(int i = 0; i < num; i++)
+    {
+        string file;
+        int    x, y, w, h;
+        Uint32 size, time, nowSize, nowTime;
+
+        if(!(inFile >> file >> x >> y >> w >> h >> size >> time))
+            return false;
+
+        //edited since it was packed
+        if(Archive::stamp(file.c_str(), nowSize, nowTime) &&
+           (nowSize != size || nowTime != time))
+            continue;
+
+        SDL_Rect r;
+        r.x = x;
+        r.y = y;
+        r.w = w;
+        r.h = h;
+        rects[file] = r;
+    }
+
+    atlas = acquire(image.c_str());
+
+    if(!atlas)
+        return false;
+
+    packed.swap(rects);
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              openArchive
+ Description:       Maps an archive written by tools/PackAssets.cpp. Images
+                    already loaded stay as they are; those loaded after come
+                    from the archive where it holds them.
+
+ Input:
+    path            The .pak file
+
+ Output:
+    returns         false if there is no archive to use; every image is then
+                    loaded from its own file
+ ******************************************************************************/
+bool TextureCache::openArchive(const char* path)
+{
+    return archive.open(path);
+}
+
+/*******************************************************************************
+ Name:              isLoaded
+ Description:       Whether an image is in memory already, on its own or in
+                    the atlas, so there is no need to prefetch it
+ ******************************************************************************/
+bool TextureCache::isLoaded(const char* path)
+{
+    if(atlas && packed.count(path))
+        return true;
+
+    return entries.count(Key(path, true)) || entries.count(Key(path, false));
+}
+
+/*******************************************************************************
+ Name:              addRef
+ Description:       Takes another reference to a surface from acquire(), for
+                    an object copying one that holds it
+ ******************************************************************************/
+void TextureCache::addRef(SDL_Surface* s)
+{
+    map<SDL_Surface*, Key>::iterator it = owners.find(s);
+
+    if(it != owners.end())
+        entries[it->second].refs++;
+}
+
+/*******************************************************************************
+ Name:              release
+ Description:       Gives back a reference. The surface stays loaded, for the
+                    next object that wants it, until trim().
+ ******************************************************************************/
+void TextureCache::release(SDL_Surface* s)
+{
+    map<SDL_Surface*, Key>::iterator it = owners.find(s);
+
+    if(it != owners.end())
+        entries[it->second].refs--;
+}
+
+/*******************************************************************************
+ Name:              trim
+ Description:       Frees every surface nobody holds
+
+ Output:
+    returns         The number freed
+ ******************************************************************************/
+int TextureCache::trim()
+{
+    int freed = 0;
+    map<Key, Entry>::iterator it = entries.begin();
+
+    while(it != entries.end())
+    {
+        if(it->second.refs <= 0)
+        {
+            resident -= it->second.bytes;
+            owners.erase(it->second.surface);
+            SDL_FreeSurface(it->second.surface);
+            entries.erase(it++);
+            freed++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return freed;
+}
+
+/*******************************************************************************
+ Name:              report
+ Description:       Prints the hit and miss counts and what is loaded
+ ******************************************************************************/
+void TextureCache::report()
+{
+    cout << "textures: " << hits << " hits, " << misses << " misses, "
+         << entries.size() << " loaded, " << resident / 1024 << " KB, "
+         << packed.size() << " sprites in the atlas, "
+         << archive.getNumLoads() << " decoded from "
+         << archive.getBytesRead() / 1024 << " KB of the archive, "
+         << archive.getNumStale() << " changed since packed" << endl;
+}
@@ -0,0 +1,104 @@
+/*******************************************************************************
+ Filename:                  TextureCache.h
+ Classname:                 TextureCache
+
+ Description:               This file declares the TextureCache class. The
+                            TextureCache loads each image file once for the
+                            whole process and hands the same surface to every
+                            object that asks for it, counting references.
+                            Surfaces are converted to the display format, and
+                            given the transparent color key, as they load, so
+                            blits need no conversion. A surface nobody holds
+                            stays loaded until trim(), which Room::load calls
+                            once the new level is built, so images shared
+                            between levels are never loaded twice.
+
+                            Small sprites can be packed ahead of time into an
+                            atlas by tools/PackAtlas.cpp. Once loadAtlas() has
+                            read its table, acquireSprite() hands out the
+                            part of the one atlas surface holding each packed
+                            file, and loads the rest on their own.
+
+                            Once openArchive() has mapped the Archive built by
+                            tools/PackAssets.cpp, images are decoded from it,
+                            already in the display format, and only those it
+                            does not hold are read from their .bmp. A
+                            Prefetcher given to setPrefetcher() decodes the
+                            images of the levels that may come next on a
+                            thread of its own; acquire() takes them from it
+                            rather than decoding them again.
+
+                            Surfaces from the cache are shared: never free or
+                            change one, release() it instead.
+ ******************************************************************************/
+
+#ifndef AngrySomething_TextureCache_h
+#define AngrySomething_TextureCache_h
+
+#include <map>
+#include <string>
+#include <cstddef>
+#include <SDL/SDL.h>
+
+#include "Archive.h"
+
+using namespace std;
+
+class Prefetcher;
+
+/*******************************************************************************
+ Struct Sprite
+ Description:       An image: the surface it is on and where on it
+ ******************************************************************************/
+struct Sprite
+{
+    SDL_Surface*    surface;
+    SDL_Rect        rect;
+};
+
+class TextureCache
+{
+    private:
+        struct Entry
+        {
+            SDL_Surface*    surface;
+            int             refs;
+            size_t          bytes;
+        };
+
+        typedef pair<string, bool>  Key;    //path, color keyed
+
+        static map<Key, Entry>              entries;
+        static map<SDL_Surface*, Key>       owners;
+        static int                          hits;
+        static int                          misses;
+        static size_t                       resident;
+
+        static map<string, SDL_Rect>        packed;     //file, rect in atlas
+        static SDL_Surface*                 atlas;
+        static Archive                      archive;
+        static Prefetcher*                  prefetcher;
+
+        static SDL_Surface* load(const char* path);
+
+    public:
+        static SDL_Surface* acquire(const char* path, bool keyed = true);
+        static Sprite       acquireSprite(const char* path);
+        static bool         loadAtlas(const char* table);
+        static bool         openArchive(const char* path);
+        static void         setPrefetcher(Prefetcher* p) {prefetcher = p;}
+        static SDL_Surface* decode(const char* path);
+        static bool         isLoaded(const char* path);
+        static void         addRef(SDL_Surface* s);
+        static void         release(SDL_Surface* s);
+        static int          trim();
+
+        static int          getHits() {return hits;}
+        static int          getMisses() {return misses;}
+        static size_t       getResidentBytes() {return resident;}
+        static int          getNumTextures() {return (int)entries.size();}
+        static int          getNumPacked() {return (int)packed.size();}
+        static void         report();
+};
+
+#endif
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ Filename:                  ThreadPool.cpp
+ Classname:                 ThreadPool
+
+ Description:               This file defines the ThreadPool class. The
+                            ThreadPool keeps a set of SDL worker threads
+                            waiting, and runs a ThreadTask over a range of
+                            indices on them and the calling thread together.
+                            run() returns once every index is done.
+ ******************************************************************************/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ThreadPool.h"
+
+/*******************************************************************************
+ Name:              ThreadPool
+ Description:       Constructor
+
+ Input:
+    threads         Threads to run tasks on, counting the caller of run()
+ ******************************************************************************/
+ThreadPool::ThreadPool(int threads)
+{
+    lock  = SDL_CreateMutex();
+    start = SDL_CreateCond();
+    done  = SDL_CreateCond();
+
+    task  = NULL;
+    count = 0;
+    next  = 0;
+    busy  = 0;
+    job   = 0;
+    quit  = false;
+
+    startWorkers(threads);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stopWorkers();
+
+    SDL_DestroyCond(done);
+    SDL_DestroyCond(start);
+    SDL_DestroyMutex(lock);
+}
+
+/*******************************************************************************
+ Name:              startWorkers, stopWorkers
+ Description:       The caller of run() always works, so threads - 1 workers
+                    are started
+ ******************************************************************************/
+void ThreadPool::startWorkers(int threads)
+{
+    quit     = false;
+    firstJob = job;
+
+    for(int i = 1; i < threads; i++)
+        workers.push_back(SDL_CreateThread(workerMain, this));
+}
+
+void ThreadPool::stopWorkers()
+{
+    SDL_LockMutex(lock);
+    quit = true;
+    SDL_CondBroadcast(start);
+    SDL_UnlockMutex(lock);
+
+    for(int i = 0; i < (int)workers.size(); i++)
+        SDL_WaitThread(workers[i], NULL);
+
+    workers.clear();
+}
+
+void ThreadPool::setNumThreads(int threads)
+{
+    if(threads < 1 || threads == getNumThreads())
+        return;
+
+    stopWorkers();
+    startWorkers(threads);
+}
+
+/*******************************************************************************
+ Name:              numCores
+ Description:       Processors available to the game, SDL 1.2 cannot say
+ ******************************************************************************/
+int ThreadPool::numCores()
+{
+    int n;
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    n = (int)info.dwNumberOfProcessors;
+#else
+    n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return n > 0 ? n : 1;
+}
+
+/*******************************************************************************
+ Name:              run
+ Description:       Calls t->runTask(i) for every i in [0, n) and waits for
+                    all of them
+
+ Input:
+    t               The task
+    n               Number of indices
+ ******************************************************************************/
+void ThreadPool::run(ThreadTask* t, int n)
+{
+    if(workers.empty() || n <= 1)
+    {
+        for(int i = 0; i < n; i++)
+            t->runTask(i);
+        return;
+    }
+
+    SDL_LockMutex(lock);
+    task  = t;
+    count = n;
+    next  = 0;
+    busy  = (int)workers.size();
+    job++;
+    SDL_CondBroadcast(start);
+    SDL_UnlockMutex(lock);
+
+    work();
+
+    SDL_LockMutex(lock);
+    while(busy > 0)
+        SDL_CondWait(done, lock);
+    task = NULL;
+    SDL_UnlockMutex(lock);
+}
+
+/*******************************************************************************
+ Name:              work
+ Description:       Takes indices of the current job until there are none left
+ ******************************************************************************/
+void ThreadPool::work()
+{
+    while(true)
+    {
+        SDL_LockMutex(lock);
+        int i = next++;
+        SDL_UnlockMutex(lock);
+
+        if(i >= count)
+            return;
+
+        task->runTask(i);
+    }
+}
+
+/*******************************************************************************
+ Name:              workerMain
+ Description:       Worker thread: waits for each new job, helps finish it,
+                    and reports back
+ ******************************************************************************/
+int ThreadPool::workerMain(void* data)
+{
+    ThreadPool* pool = (ThreadPool*)data;
+    int         seen = pool->firstJob;
+
+    SDL_LockMutex(pool->lock);
+
+    while(true)
+    {
+        while(!pool->quit && pool->job == seen)
+            SDL_CondWait(pool->start, pool->lock);
+
+        if(pool->quit)
+            break;
+
+        seen = pool->job;
+        SDL_UnlockMutex(pool->lock);
+
+        pool->work();
+
+        SDL_LockMutex(pool->lock);
+        if(--pool->busy == 0)
+            SDL_CondSignal(pool->done);
+    }
+
+    SDL_UnlockMutex(pool->lock);
+    return 0;
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ Filename:                  ThreadPool.h
+ Classname:                 ThreadPool, ThreadTask
+
+ Description:               This file declares the ThreadPool class. The
+                            ThreadPool keeps a set of SDL worker threads
+                            waiting, and runs a ThreadTask over a range of
+                            indices on them and the calling thread together.
+                            run() returns once every index is done.
+ ******************************************************************************/
+
+#ifndef AngrySomething_ThreadPool_h
+#define AngrySomething_ThreadPool_h
+
+#include <vector>
+#include <SDL/SDL.h>
+
+using namespace std;
+
+/*******************************************************************************
+ Class ThreadTask
+ Description:       Work handed to ThreadPool::run. runTask is called once
+                    for every index, from any thread, in no set order.
+ ******************************************************************************/
+class ThreadTask
+{
+    public:
+        virtual ~ThreadTask() {}
+        virtual void runTask(int i) = 0;
+};
+
+class ThreadPool
+{
+    private:
+        vector<SDL_Thread*> workers;
+        SDL_mutex*          lock;
+        SDL_cond*           start;
+        SDL_cond*           done;
+
+        //the job in progress, guarded by lock
+        ThreadTask*         task;
+        int                 count;
+        int                 next;
+        int                 busy;
+        int                 job;
+        int                 firstJob;   //job count when the workers started
+        bool                quit;
+
+        static int  workerMain(void* data);
+
+        void    work();
+        void    startWorkers(int threads);
+        void    stopWorkers();
+
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+    public:
+        ThreadPool(int threads = 1);
+        ~ThreadPool();
+
+        void    run(ThreadTask* t, int n);
+
+        void    setNumThreads(int threads);
+        int     getNumThreads() {return (int)workers.size() + 1;}
+
+        static int  numCores();
+};
+
+#endif
@@ -6,6 +6,7 @@
  ******************************************************************************/
 
 #include "UFObird.h"
+#include "TextureCache.h"
 #include <cmath>
 
 UFObird::UFObird(const char* file, const char* file2, int x, int y, int vx, int vy)
@@ -14,10 +15,15 @@ UFObird::UFObird(const char* file, const char* file2, int x, int y, int vx, int
 
 {
     type = 1;
-    numBirds++;
     image2 = file2;
     UFOactive = false;
 
+    //loaded once here, not every frame in draw
+    Spaceship.surface = NULL;
+
+    if(!isHeadless())
+        Spaceship = TextureCache::acquireSprite(image2);
+
     activeDraw = true;
     activePhys = true;
     activeMech = true;
@@ -26,12 +32,12 @@ UFObird::UFObird(const char* file, const char* file2, int x, int y, int vx, int
 
 UFObird::~UFObird()
 {
-    numBirds--;
+    TextureCache::release(Spaceship.surface);
 }
 
 void UFObird::run()
 {
-    move();
+    Vect vel = getVel();
 
     if(pow((pow(vel.y,2) + pow(vel.x, 2)), .5) < 1)
     {
@@ -50,10 +56,8 @@ Object* UFObird::process()
     if(pos.x >= 350 and pos.y >= 25)
     {
         UFOactive = true;
-        vel.x = 0;
-        vel.y = -1;
-        acc.x = 0;
-        acc.y = -1;
+        setVel(Vect(0, -1));
+        setAcc(Vect(0, -1));
         pos.x = 350;
     }
 
@@ -62,28 +66,47 @@ Object* UFObird::process()
 
 void UFObird::draw(SDL_Surface* s)
 {
-    SDL_Rect temp;
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect temp = shipLoc();
+    SDL_Rect loc = pos;
+
+    Blitter::blit(image, &frame, s, &loc);
+    if(UFOactive)
+        Blitter::blit(Spaceship.surface, &Spaceship.rect, s, &temp);
+}
+
+/*******************************************************************************
+ Name:              shipLoc
+ Description:       Where the spaceship is drawn once the bird reaches it
+ ******************************************************************************/
+SDL_Rect UFObird::shipLoc()
+{
+    SDL_Rect r;
+
+    r.x = 250;
+    r.w = 200;
+    r.y = 10;
+    r.h = 100;
 
-    temp.x = 250;
-    temp.w = 200;
-    temp.y = 10;
-    temp.h = 100;
+    return r;
+}
 
-    Spaceship = SDL_LoadBMP(image2);
+/*******************************************************************************
+ Name:              getBounds
+ Description:       The bird, and the spaceship while it is showing
+ ******************************************************************************/
+SDL_Rect UFObird::getBounds()
+{
+    SDL_Rect r = Projectile::getBounds();
 
-    if(!image2)
+    if(UFOactive && Spaceship.surface)
     {
-        exit(0);
+        SDL_Rect ship = shipLoc();
+        ship.w = Spaceship.rect.w;
+        ship.h = Spaceship.rect.h;
+        r = unite(r, ship);
     }
 
-    Uint32 colorkey = SDL_MapRGB( Spaceship->format, 0xFF, 0xAE, 0xC9);
-    SDL_SetColorKey( Spaceship, SDL_SRCCOLORKEY, colorkey );
-
-    SDL_BlitSurface(image, NULL, s, &loc);
-    if(UFOactive)
-        SDL_BlitSurface(Spaceship, NULL, s, &temp);
+    return r;
 }
 
 void UFObird::pause()
@@ -7,17 +7,19 @@ class UFObird : public Projectile
 {
     private:
         const char* image2;
-        SDL_Surface* Spaceship;
+        Sprite Spaceship;
         bool UFOactive;
+
+        SDL_Rect        shipLoc();
     public:
         UFObird(const char* file,const char* file2, int x, int y, int vx, int vy);
         ~UFObird();
 
         void            run();
         void            draw(SDL_Surface* s);
+        SDL_Rect        getBounds();
         Object*         process();
 
-        static int      getNumBirds(){return numBirds;}
         void            pause();
         void            unpause();
 };
@@ -19,31 +19,15 @@ Wall::~Wall()
     adjustScore(50);
 }
 
-void Wall::run()
-{
-    move();
-}
+/*******************************************************************************
+ Name:              impact
+ Description:       Hard enough hits damage the wall
 
-void Wall::applyForce(int m, Vect v, int dir)
+ Input:
+    v               Velocity of the hit relative to the wall
+ ******************************************************************************/
+void Wall::impact(Vect v)
 {
-    if(dir == 0)
-    {
-        v.y = vel.y * .8;   //friction
-        acc.x += ((m * (v.x - vel.x)) / mass) * .5;
-        acc.y += (v.y - vel.y) * .8;
-    }
-    else if(dir == 1)
-    {
-        v.x = vel.x * .8;   //friction
-        acc.x += (v.x - vel.x) * .8;
-        acc.y += ((m * (v.y - vel.y)) / mass) * .35;
-    }
-    else
-    {
-        acc.x += ((m * (v.x - vel.x)) / mass) * .5;
-        acc.y += ((m * (v.y - vel.y)) / mass) * .35;
-    }
-    
     if(pow((pow(v.y,2) + pow(v.x, 2)), .5) > 30)
     {
         health -= 50;
@@ -57,8 +41,7 @@ void Wall::applyForce(int m, Vect v, int dir)
 /*
 void Wall::draw(SDL_Surface* screen)
 {
-    static SDL_Rect loc;
-    loc = pos;
+    SDL_Rect loc = pos;
 
     SDL_BlitSurface(image, NULL, screen, &loc);
 }
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ Filename:                  World.cpp
+ Classname:                 World
+
+ Description:               This file defines the World struct.
+ ******************************************************************************/
+
+#include "World.h"
+
+/*******************************************************************************
+ Name:              World
+ Description:       Constructor. The counts are kept by the objects
+                    themselves as they join and leave the world.
+ ******************************************************************************/
+World::World()
+{
+    numPigs    = 0;
+    numBirds   = 0;
+    slingBirds = 0;
+    score      = 0;
+    level      = 0;
+    paused     = false;
+    fieldW     = FIELD_W;
+    fieldH     = FIELD_H;
+
+    bodiesRemoved = 0;
+}
+
+/*******************************************************************************
+ Name:              track
+ Description:       Gives an object a slot in the Handle table, reusing the
+                    slot of a destroyed object when there is one
+
+ Output:
+    returns         The object's Handle
+ ******************************************************************************/
+Handle World::track(Object* obj)
+{
+    int i;
+
+    if(freeSlots.empty())
+    {
+        i = (int)slotObject.size();
+        slotObject.push_back(NULL);
+        slotGeneration.push_back(0);
+    }
+    else
+    {
+        i = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    slotObject[i] = obj;
+
+    return Handle(i, slotGeneration[i]);
+}
+
+/*******************************************************************************
+ Name:              untrack
+ Description:       Frees an object's slot. The generation goes up, so every
+                    Handle to the object now looks up as NULL.
+ ******************************************************************************/
+void World::untrack(Handle h)
+{
+    if(!lookup(h))
+        return;
+
+    slotObject[h.index] = NULL;
+    slotGeneration[h.index]++;
+    freeSlots.push_back(h.index);
+}
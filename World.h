@@ -0,0 +1,72 @@
+/*******************************************************************************
+ Filename:                  World.h
+ Classname:                 World
+
+ Description:               This file declares the World struct. A World is
+                            the game state that belongs to one Room rather
+                            than to the process: the motion of its bodies, the
+                            pigs and birds left, the score, and which level it
+                            holds. Objects reach it through the pointer Room
+                            gives them when they are added, so any number of
+                            Rooms can exist and step at once.
+
+                            The World also keeps the table that Handles are
+                            looked up in, so objects can refer to each other
+                            without holding pointers.
+
+                            The field is the part of the world bodies stay
+                            in, which may be bigger than the screen; the
+                            Camera is the part of it on the screen.
+ ******************************************************************************/
+
+#ifndef AngrySomething_World_h
+#define AngrySomething_World_h
+
+#include <vector>
+
+#include "BodyStore.h"
+#include "Handle.h"
+#include "Camera.h"
+
+using namespace std;
+
+class Object;
+
+struct World
+{
+    BodyStore   bodies;
+    int         numPigs;
+    int         numBirds;       //birds in flight
+    int         slingBirds;     //birds still waiting in a sling
+    int         score;
+    int         level;          //StateEngine's number for the loaded level
+    bool        paused;
+    int         fieldW;
+    int         fieldH;
+    Camera      camera;
+    int         bodiesRemoved;  //ever, so PhysicsEngine sees any removal
+
+    //Handle table: the object in each slot and the slot's generation
+    vector<Object*> slotObject;
+    vector<int>     slotGeneration;
+    vector<int>     freeSlots;
+
+    static const int    FIELD_W = 1280;     //unless the level says
+    static const int    FIELD_H = 720;
+    static const int    MAX_FIELD = 32767;  //SDL_Rect coordinates are Sint16
+
+    World();
+
+    Handle      track(Object* obj);
+    void        untrack(Handle h);
+
+    Object*     lookup(Handle h) const
+    {
+        if(h.index < 0 || h.index >= (int)slotObject.size() ||
+           slotGeneration[h.index] != h.generation)
+            return NULL;
+        return slotObject[h.index];
+    }
+};
+
+#endif
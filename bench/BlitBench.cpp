@@ -0,0 +1,189 @@
+/*******************************************************************************
+ Filename:                  BlitBench.cpp
+
+ Description:               Benchmark for the color keyed blit kernels. Loads
+                            sprites of each size the game draws, in the
+                            display format with the transparent color key,
+                            and blits each across the screen with SDL's
+                            generic blitter and with every kernel Blitter
+                            has on this CPU. Reports megapixels per second
+                            and speedup over SDL, and checks that each kernel
+                            leaves the screen exactly as SDL does.
+
+                            Build and run from the repository root (it loads
+                            the game's bitmaps), on a kiosk or with
+                            SDL_VIDEODRIVER=dummy:
+                            g++ -O2 -I. bench/BlitBench.cpp Blitter.cpp \
+                                DrawList.cpp TextureCache.cpp TextCache.cpp \
+                                Archive.cpp Lz4.cpp Prefetcher.cpp -lSDL
+                            ./a.out [ms per test]
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <SDL/SDL.h>
+
+#include "Blitter.h"
+#include "TextureCache.h"
+
+using namespace std;
+
+//one of each size drawn: bird, level icon, menu button, monkey, slingshot,
+//UFO, level picture, big level picture
+const char* SPRITES[] = {"AngryBird.bmp", "Apathos1.bmp", "Menu.bmp", "Monkey.bmp",
+                         "Slingshot.bmp", "UFO.bmp", "Apathos.bmp", "Cordona_Big.bmp"};
+const int   NUM_SPRITES = sizeof(SPRITES) / sizeof(SPRITES[0]);
+
+const int   DEFAULT_MS  = 200;
+const int   STEP        = 37;   //px between blits, so rows start unaligned
+
+/*******************************************************************************
+ Name:              hashScreen
+ Description:       FNV-1a over the pixels of the screen
+ ******************************************************************************/
+static unsigned long hashScreen(SDL_Surface* s)
+{
+    unsigned long h = 2166136261UL;
+
+    for(int y = 0; y < s->h; y++)
+    {
+        Uint8* p = (Uint8*)s->pixels + y * s->pitch;
+
+        for(int x = 0; x < s->w * s->format->BytesPerPixel; x++)
+            h = (h ^ p[x]) * 16777619UL;
+    }
+
+    return h;
+}
+
+/*******************************************************************************
+ Name:              pass
+ Description:       Clears the screen and blits the sprite in rows across it
+
+ Output:
+    returns         Pixels drawn
+ ******************************************************************************/
+static double pass(SDL_Surface* screen, SDL_Surface* sprite)
+{
+    double pixels = 0;
+
+    SDL_FillRect(screen, NULL, 0);
+
+    for(int y = 0; y + sprite->h <= screen->h; y += STEP)
+    {
+        for(int x = 0; x + sprite->w <= screen->w; x += STEP)
+        {
+            SDL_Rect loc;
+            loc.x = x;
+            loc.y = y;
+
+            Blitter::blit(sprite, NULL, screen, &loc);
+            pixels += sprite->w * sprite->h;
+        }
+    }
+
+    return pixels;
+}
+
+/*******************************************************************************
+ Name:              measure
+ Description:       Repeats passes for at least ms milliseconds
+
+ Output:
+    hash            The screen after one pass
+    returns         Megapixels per second
+ ******************************************************************************/
+static double measure(SDL_Surface* screen, SDL_Surface* sprite, int ms,
+                      unsigned long& hash)
+{
+    pass(screen, sprite);
+    hash = hashScreen(screen);
+
+    double total  = 0;
+    Uint32 t0     = SDL_GetTicks();
+    Uint32 t1     = t0;
+
+    while(t1 - t0 < (Uint32)ms)
+    {
+        total += pass(screen, sprite);
+        t1 = SDL_GetTicks();
+    }
+
+    return total / 1e6 / ((t1 - t0) / 1000.0);
+}
+
+int main(int argc, char* argv[])
+{
+    int ms = argc > 1 ? atoi(argv[1]) : DEFAULT_MS;
+
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+
+    SDL_Surface* screen = SDL_SetVideoMode(1280, 720, 32, SDL_SWSURFACE);
+
+    if(!screen)
+    {
+        fprintf(stderr, "%s\n", SDL_GetError());
+        return 1;
+    }
+
+    int best = Blitter::getKernel();
+
+    printf("kernels:");
+    for(int k = 0; k < NUM_KERNELS; k++)
+    {
+        if(Blitter::hasKernel(k))
+            printf(" %s%s", Blitter::kernelName(k), k == best ? " (picked)" : "");
+    }
+    printf("\n\nsprite           size     SDL Mpx/s");
+    for(int k = 0; k < NUM_KERNELS; k++)
+    {
+        if(Blitter::hasKernel(k))
+            printf("  %6s Mpx/s ", Blitter::kernelName(k));
+    }
+    printf("\n");
+
+    bool same = true;
+
+    for(int i = 0; i < NUM_SPRITES; i++)
+    {
+        SDL_Surface* sprite = TextureCache::acquire(SPRITES[i]);
+
+        if(!sprite)
+        {
+            fprintf(stderr, "cannot load %s\n", SPRITES[i]);
+            continue;
+        }
+
+        unsigned long sdlHash, hash;
+
+        Blitter::setGeneric(true);
+        double sdl = measure(screen, sprite, ms, sdlHash);
+        Blitter::setGeneric(false);
+
+        printf("%-16s %3dx%-3d  %9.0f", SPRITES[i], sprite->w, sprite->h, sdl);
+
+        for(int k = 0; k < NUM_KERNELS; k++)
+        {
+            if(!Blitter::setKernel(k))
+                continue;
+
+            double mpx = measure(screen, sprite, ms, hash);
+
+            printf("  %6.0f %4.1fx%s", mpx, sdl > 0 ? mpx / sdl : 0,
+                   hash == sdlHash ? " " : "!");
+            same = same && hash == sdlHash;
+        }
+        printf("\n");
+
+        TextureCache::release(sprite);
+    }
+
+    Blitter::setKernel(best);
+
+    printf(same ? "\nsame pixels as SDL: yes\n" : "\nsame pixels as SDL: NO (marked !)\n");
+
+    TextureCache::trim();
+    SDL_Quit();
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ Filename:                  CircleContactBench.cpp
+
+ Description:               Microbenchmark for the circle narrowphase. Times
+                            the old trig path used by handleCollision
+                            (pointOfIntersection, Vect::angle, cos/sin) against
+                            findContact with dot products, on the same random
+                            circle pairs, and checks both give the same push.
+
+                            Build from the repository root:
+                            g++ -O2 -I. bench/CircleContactBench.cpp Geometry.cpp
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "Geometry.h"
+
+using namespace std;
+
+const int    NUM_PAIRS  = 4096;
+const int    NUM_ROUNDS = 500;
+const double MIN_COS    = .0998;    //cos(pi/2 - .1), as in PhysicsEngine
+
+struct Case
+{
+    Circle  a, b;
+    Vect    vel;
+};
+
+/*******************************************************************************
+ Name:              trigPush
+ Description:       The narrowphase as it was before findContact
+ ******************************************************************************/
+static Vect trigPush(Case& k)
+{
+    Point i = pointOfIntersection(k.a, k.b);
+    Vect  l = Vect(i, k.b.cent);
+
+    double ang1 = l.angle();
+    double ang2 = k.vel.angle();
+    double ang3 = ang2 - ang1;
+
+    if(abs(ang3) <= (M_PI / 2) - .1 && k.vel.len())
+    {
+        double fm = k.vel.len() * cos(ang3);
+        return Vect(fm * cos(ang1), fm * sin(ang1));
+    }
+    return Vect(0, 0);
+}
+
+/*******************************************************************************
+ Name:              dotPush
+ Description:       The narrowphase PhysicsEngine uses now
+ ******************************************************************************/
+static Vect dotPush(Case& k)
+{
+    Contact c;
+
+    if(!findContact(k.a, k.b, c))
+        return Vect(0, 0);
+
+    double speed = k.vel.len();
+    double fm    = k.vel.dot(c.normal);
+
+    if(speed && fm >= speed * MIN_COS)
+        return c.normal * fm;
+    return Vect(0, 0);
+}
+
+int main()
+{
+    vector<Case> cases(NUM_PAIRS);
+    srand(1);
+
+    //touching or overlapping projectile-sized circles
+    for(int i = 0; i < NUM_PAIRS; i++)
+    {
+        Case& k = cases[i];
+        k.a   = Circle(Point(600 + rand() % 20, 300 + rand() % 20), 25);
+        k.b   = Circle(Point(600 + rand() % 40, 300 + rand() % 40), 25);
+        k.vel = Vect(rand() % 41 - 20, rand() % 41 - 20);
+    }
+
+    double sum = 0;
+    int    agree = 0, bothHit = 0;
+
+    clock_t t0 = clock();
+    for(int r = 0; r < NUM_ROUNDS; r++)
+        for(int i = 0; i < NUM_PAIRS; i++)
+            sum += trigPush(cases[i]).x;
+    clock_t t1 = clock();
+    for(int r = 0; r < NUM_ROUNDS; r++)
+        for(int i = 0; i < NUM_PAIRS; i++)
+            sum += dotPush(cases[i]).x;
+    clock_t t2 = clock();
+
+    //the old path rounds the contact point to whole pixels, so allow slack
+    for(int i = 0; i < NUM_PAIRS; i++)
+    {
+        Vect p = trigPush(cases[i]);
+        Vect q = dotPush(cases[i]);
+
+        if(p.len() && q.len())
+        {
+            bothHit++;
+            if(Vect(p.x - q.x, p.y - q.y).len() < .1 * p.len() + .5)
+                agree++;
+        }
+    }
+
+    double n      = (double)NUM_PAIRS * NUM_ROUNDS;
+    double trigNs = (t1 - t0) * 1e9 / CLOCKS_PER_SEC / n;
+    double dotNs  = (t2 - t1) * 1e9 / CLOCKS_PER_SEC / n;
+
+    printf("trig path:  %6.1f ns/contact\n", trigNs);
+    printf("dot path:   %6.1f ns/contact (%.1fx)\n", dotNs, trigNs / dotNs);
+    printf("agreement:  %d of %d contacts both paths push\n", agree, bothHit);
+    printf("(checksum %g)\n", sum);
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ Filename:                  CompositorBench.cpp
+
+ Description:               Frame hash test and benchmark for the tile
+                            parallel Compositor. Plays each level with a bird
+                            launched, drawing every frame whole, first the way
+                            the GraphicsEngine drew before tiles (one piece,
+                            one thread, every blit through SDL), then tiled on
+                            1 to N threads, then in dirty rectangle mode, then
+                            that again on the render thread, waiting for each
+                            frame to be drawn. A hash of every frame must
+                            match the first run's. Siege1 is a field four
+                            screens big, with its structures past the edges
+                            of their pictures, so the camera scrolls.
+                            Reports time per frame and speedup over the first
+                            run.
+
+                            Build and run from the repository root (the levels
+                            use its bitmaps), on a kiosk or with
+                            SDL_VIDEODRIVER=dummy:
+                            g++ -O2 -I. bench/CompositorBench.cpp \
+                                $(ls *.cpp | grep -v Main.cpp) \
+                                -lSDL -lSDL_ttf -lSDL_mixer
+                            ./a.out [threads] [frames] [level.gel ...]
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <SDL/SDL.h>
+
+#include "Room.h"
+#include "GraphicsEngine.h"
+#include "PhysicsEngine.h"
+#include "MechanicsEngine.h"
+#include "TextureCache.h"
+#include "Blitter.h"
+#include "Sling.h"
+
+using namespace std;
+
+const int LAUNCH_FRAME = 30;
+const int FRAMES_PER_TICK = 2;  //drawn between physics ticks, interpolated
+
+/*******************************************************************************
+ Name:              hashScreen
+ Description:       FNV-1a over the pixels of the screen
+ ******************************************************************************/
+static unsigned long hashScreen(SDL_Surface* s)
+{
+    unsigned long h = 2166136261UL;
+
+    for(int y = 0; y < s->h; y++)
+    {
+        Uint8* p = (Uint8*)s->pixels + y * s->pitch;
+
+        for(int x = 0; x < s->w * s->format->BytesPerPixel; x++)
+            h = (h ^ p[x]) * 16777619UL;
+    }
+
+    return h;
+}
+
+/*******************************************************************************
+ Name:              play
+ Description:       Plays a level, launching a bird, and draws every frame
+
+ Output:
+    hashes          One per frame
+    returns         Milliseconds spent drawing, per frame
+ ******************************************************************************/
+static double play(const char* level, int frames, GraphicsEngine& grph,
+                   vector<unsigned long>& hashes)
+{
+    Room            room;
+    PhysicsEngine   phys(1);
+    MechanicsEngine mech;
+    Sling*          sling = NULL;
+    Uint32          drawing = 0;
+
+    hashes.clear();
+
+    if(!room.load(level))
+        return 0;
+
+    for(int i = 0; i < room.getNumObjects() && !sling; i++)
+        sling = dynamic_cast<Sling*>(room.getObjectAt(i));
+
+    for(int f = 0; f < frames; f++)
+    {
+        if(f == LAUNCH_FRAME && sling)
+            sling->adopt(room.add(sling->launch(Vect(20, -6))));
+
+        if(f % FRAMES_PER_TICK == 0)
+        {
+            for(int i = 0; i < room.getNumObjects(); i++)
+            {
+                if(room.getObjectAt(i)->getState() == -1)
+                    room.remove(room.getObjectAt(i)->getHandle());
+            }
+            room.purge();
+
+            mech.run(room);
+            phys.run(room);
+            room.getCamera().step(room.getWorld());
+        }
+
+        Uint32 t0 = SDL_GetTicks();
+        grph.run(room, (double)(f % FRAMES_PER_TICK) / FRAMES_PER_TICK);
+        grph.finish();
+        drawing += SDL_GetTicks() - t0;
+
+        hashes.push_back(hashScreen(grph.getScreen()));
+    }
+
+    return (double)drawing / frames;
+}
+
+/*******************************************************************************
+ Name:              mismatches
+ Description:       Frames whose hash differs from the reference
+ ******************************************************************************/
+static int mismatches(vector<unsigned long>& a, vector<unsigned long>& b)
+{
+    int n = a.size() == b.size() ? 0 : (int)max(a.size(), b.size());
+
+    for(int i = 0; i < (int)min(a.size(), b.size()); i++)
+    {
+        if(a[i] != b[i])
+            n++;
+    }
+
+    return n;
+}
+
+int main(int argc, char* argv[])
+{
+    int maxThreads = argc > 1 ? atoi(argv[1]) : ThreadPool::numCores();
+    int frames     = argc > 2 ? atoi(argv[2]) : 600;
+
+    vector<const char*> levels;
+
+    for(int i = 3; i < argc; i++)
+        levels.push_back(argv[i]);
+
+    if(levels.empty())
+    {
+        levels.push_back("Cordona1.gel");
+        levels.push_back("Knoxen2.gel");
+        levels.push_back("Ziggurat1.gel");
+        levels.push_back("Siege1.gel");
+    }
+
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
+
+    bool same = true;
+
+    for(int l = 0; l < (int)levels.size(); l++)
+    {
+        vector<unsigned long> reference, hashes;
+        double                base;
+
+        printf("%s, %d frames\n", levels[l], frames);
+        printf("  mode            ms/frame  speedup  mismatches\n");
+
+        //as drawn before tiles
+        {
+            GraphicsEngine grph(1);
+
+            TextureCache::loadAtlas("Sprites.atlas");
+            grph.setDirtyRects(false);
+            grph.setTileSize(grph.getScreen()->w, grph.getScreen()->h);
+            Blitter::setGeneric(true);
+
+            base = play(levels[l], frames, grph, reference);
+
+            Blitter::setGeneric(false);
+        }
+
+        if(reference.empty())
+        {
+            fprintf(stderr, "cannot load %s\n", levels[l]);
+            same = false;
+            continue;
+        }
+
+        printf("  untiled SDL     %8.3f  %6.2fx  %10d\n", base, 1.0, 0);
+
+        for(int n = 1; n <= maxThreads + 2; n++)
+        {
+            //the last two runs are dirty rectangle mode, on every thread,
+            //the second pipelined
+            bool           dirty = n > maxThreads;
+            bool           piped = n > maxThreads + 1;
+            GraphicsEngine grph(dirty ? maxThreads : n);
+
+            grph.setDirtyRects(dirty);
+            grph.setPipelined(piped);
+
+            double ms  = play(levels[l], frames, grph, hashes);
+            int    bad = mismatches(reference, hashes);
+
+            same = same && bad == 0;
+
+            printf("  %-7s %2d thr  %8.3f  %6.2fx  %10d\n",
+                   piped ? "piped" : dirty ? "dirty" : "tiled",
+                   grph.getNumThreads(), ms, ms > 0 ? base / ms : 0, bad);
+        }
+    }
+
+    printf(same ? "pixel identical: yes\n" : "pixel identical: NO\n");
+
+    SDL_Quit();
+
+    return same ? 0 : 1;
+}
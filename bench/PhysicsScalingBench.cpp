@@ -0,0 +1,166 @@
+/*******************************************************************************
+ Filename:                  PhysicsScalingBench.cpp
+
+ Description:               Scaling benchmark for the island-parallel
+                            PhysicsEngine. Writes a generated level of
+                            separate towers, then steps it from rest with 1 to
+                            N solver threads, reporting time per tick, speedup
+                            over one thread, and a hash of every body's
+                            position and velocity, which must be the same for
+                            every thread count.
+
+                            Build and run from the repository root (the level
+                            uses its bitmaps):
+                            g++ -O2 -I. bench/PhysicsScalingBench.cpp \
+                                $(ls *.cpp | grep -v Main.cpp) \
+                                -lSDL -lSDL_ttf -lSDL_mixer
+                            ./a.out [threads] [towers] [layers] [ticks]
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <SDL/SDL.h>
+
+#include "Room.h"
+#include "PhysicsEngine.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+const char*  LEVEL_FILE = "bench_scaling.gel";
+const int    TOWER_W    = 100;
+const int    TOWER_GAP  = 4;      //px between towers, so each is an island
+const int    FLOOR_Y    = 699;
+
+/*******************************************************************************
+ Name:              writeLevel
+ Description:       Towers of planks on pillars, a pig on each, with a pixel
+                    of air under every layer so they all settle at once
+ ******************************************************************************/
+static bool writeLevel(int towers, int layers)
+{
+    ofstream out(LEVEL_FILE);
+
+    if(!out)
+        return false;
+
+    out << "Space.bmp\n1\n" << towers * (layers + layers / 2 + 1) << "\n";
+
+    for(int t = 0; t < towers; t++)
+    {
+        int x = 2 + t * (TOWER_W + TOWER_GAP);
+        int y = FLOOR_Y;
+
+        for(int i = 0; i < layers; i++)
+        {
+            if(i % 2 == 0)
+            {
+                y -= 21;
+                out << "7 PlankH.bmp " << x << " " << y << " 0 0 100 20\n";
+            }
+            else
+            {
+                y -= 61;
+                out << "7 PlankV.bmp " << x << " " << y << " 0 0 20 60\n";
+                out << "7 PlankV.bmp " << x + 80 << " " << y << " 0 0 20 60\n";
+            }
+        }
+        out << "2 Enemy.bmp " << x + 40 << " " << y - 21 << " 0 0\n";
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              hashWorld
+ Description:       FNV-1a over every position and velocity, in room order
+                    (BodyStore slots are reused, so differ between runs)
+ ******************************************************************************/
+static unsigned long hashWorld(Room& room, unsigned long h)
+{
+    for(int i = 0; i < room.getNumObjects(); i++)
+    {
+        Object*  obj = room.getObjectAt(i);
+        SDL_Rect p   = obj->getPos();
+
+        h = (h ^ (unsigned long)(p.x * 65536 + p.y)) * 16777619UL;
+
+        if(!obj->isPhysical())
+            continue;
+
+        Vect v = dynamic_cast<PhysicalObject*>(obj)->getVel();
+        unsigned char bytes[2 * sizeof(double)];
+
+        memcpy(bytes, &v.x, sizeof(double));
+        memcpy(bytes + sizeof(double), &v.y, sizeof(double));
+
+        for(int b = 0; b < (int)sizeof(bytes); b++)
+            h = (h ^ bytes[b]) * 16777619UL;
+    }
+
+    return h;
+}
+
+int main(int argc, char* argv[])
+{
+    int maxThreads = argc > 1 ? atoi(argv[1]) : ThreadPool::numCores();
+    int towers     = argc > 2 ? atoi(argv[2]) : 12;
+    int layers     = argc > 3 ? atoi(argv[3]) : 12;
+    int ticks      = argc > 4 ? atoi(argv[4]) : 240;
+
+    SDL_Init(SDL_INIT_TIMER);
+
+    if(!writeLevel(towers, layers))
+    {
+        fprintf(stderr, "cannot write %s\n", LEVEL_FILE);
+        return 1;
+    }
+
+    printf("%d towers x %d layers, %d ticks\n", towers, layers, ticks);
+    printf("threads  ms/tick  speedup  islands  hash\n");
+
+    double        base = 0;
+    unsigned long first = 0;
+    bool          same = true;
+
+    for(int n = 1; n <= maxThreads; n++)
+    {
+        Room          room;
+        PhysicsEngine phys;
+        unsigned long h = 2166136261UL;
+        int           islands = 0;
+
+        room.load(LEVEL_FILE);
+        phys.setNumThreads(n);
+
+        Uint32 t0 = SDL_GetTicks();
+        for(int t = 0; t < ticks; t++)
+        {
+            phys.run(room);
+            h = hashWorld(room, h);
+            if(phys.getNumIslands() > islands)
+                islands = phys.getNumIslands();
+        }
+        Uint32 t1 = SDL_GetTicks();
+
+        double ms = (double)(t1 - t0) / ticks;
+        if(n == 1)
+        {
+            base  = ms;
+            first = h;
+        }
+        same = same && h == first;
+
+        printf("%7d  %7.3f  %6.2fx  %7d  %08lx\n",
+               n, ms, ms > 0 ? base / ms : 0, islands, h);
+    }
+
+    printf(same ? "deterministic: yes\n" : "deterministic: NO\n");
+
+    remove(LEVEL_FILE);
+    SDL_Quit();
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ Filename:                  PackAssets.cpp
+
+ Description:               Build step that packs the game's images into one
+                            Archive (see Archive.h), which TextureCache reads
+                            in place of the loose .bmp files. Each image is
+                            converted to 32 bit pixels, red, green, blue from
+                            the high byte down, the format a 32 bit display
+                            uses on the PCs the game runs on, so loading it
+                            is only decompression; on a display that differs
+                            TextureCache converts it as it would a .bmp. Each
+                            is then compressed with Lz4 on its own. Reports
+                            the size on disk before and after.
+
+                            Images missing from the archive are still read
+                            from their .bmp, and so are those whose .bmp has
+                            changed size or modification time since it was
+                            packed, so an edited image shows at once; run it
+                            again to pack the edit.
+
+                            Build from the repository root:
+                            g++ -O2 -I. tools/PackAssets.cpp Archive.cpp \
+                                Lz4.cpp -lSDL
+
+                            Usage, from the directory the game runs in, after
+                            tools/PackAtlas.cpp so the atlas is packed too:
+                            packassets [-o Assets.pak] *.bmp
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <SDL/SDL.h>
+
+#include "Archive.h"
+#include "Lz4.h"
+
+using namespace std;
+
+const Uint32 RMASK = 0xFF0000;
+const Uint32 GMASK = 0x00FF00;
+const Uint32 BMASK = 0x0000FF;
+
+const int    HEADER_SIZE = 28;
+const int    ENTRY_SIZE  = 22;  //and the name
+const int    MAX_SIDE    = 65535;
+
+struct Packed
+{
+    string                  file;
+    int                     w, h;
+    Uint32                  sourceSize;
+    Uint32                  sourceTime;
+    vector<unsigned char>   data;
+};
+
+static void put16(vector<unsigned char>& out, Uint32 v)
+{
+    out.push_back((unsigned char)(v & 0xFF));
+    out.push_back((unsigned char)(v >> 8));
+}
+
+static void put32(vector<unsigned char>& out, Uint32 v)
+{
+    put16(out, v & 0xFFFF);
+    put16(out, v >> 16);
+}
+
+/*******************************************************************************
+ Name:              pack
+ Description:       Converts an image to the archive's format and compresses
+                    its pixels
+
+ Output:
+    p               The image, compressed
+    returns         false if it could not be loaded or is too big
+ ******************************************************************************/
+static bool pack(const char* path, Packed& p)
+{
+    //taken first, so an edit made while packing is caught next time
+    if(!Archive::stamp(path, p.sourceSize, p.sourceTime))
+        return false;
+
+    SDL_Surface* image = SDL_LoadBMP(path);
+
+    if(!image)
+        return false;
+
+    if(image->w > MAX_SIDE || image->h > MAX_SIDE)
+    {
+        SDL_FreeSurface(image);
+        return false;
+    }
+
+    SDL_Surface* s = SDL_CreateRGBSurface(SDL_SWSURFACE, image->w, image->h, 32,
+                                          RMASK, GMASK, BMASK, 0);
+
+    if(!s)
+    {
+        SDL_FreeSurface(image);
+        return false;
+    }
+
+    SDL_BlitSurface(image, NULL, s, NULL);
+    SDL_FreeSurface(image);
+
+    int                   row = s->w * 4;
+    vector<unsigned char> pixels(row * s->h);
+
+    for(int y = 0; y < s->h; y++)
+        memcpy(&pixels[y * row], (Uint8*)s->pixels + y * s->pitch, row);
+
+    p.file = path;
+    p.w    = s->w;
+    p.h    = s->h;
+    p.data.resize(Lz4::bound((int)pixels.size()));
+
+    int n = Lz4::compress(&pixels[0], (int)pixels.size(), &p.data[0], (int)p.data.size());
+
+    p.data.resize(n > 0 ? n : 0);
+    SDL_FreeSurface(s);
+
+    return n > 0;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: packassets [-o file] file.bmp ...\n"
+                    "  -o file   the archive to write (default: Assets.pak)\n");
+}
+
+int main(int argc, char* argv[])
+{
+    string          name = "Assets.pak";
+    vector<string>  files;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "-o") && i + 1 < argc)
+            name = argv[++i];
+        else if(argv[i][0] == '-')
+        {
+            usage();
+            return 2;
+        }
+        else
+            files.push_back(argv[i]);
+    }
+
+    if(files.empty())
+    {
+        usage();
+        return 2;
+    }
+
+    SDL_Init(0);
+
+    vector<Packed> images;
+    long           before = 0;
+    long           raw    = 0;
+
+    for(int i = 0; i < (int)files.size(); i++)
+    {
+        Packed p;
+
+        if(!pack(files[i].c_str(), p))
+        {
+            fprintf(stderr, "  %s: cannot load, left out\n", files[i].c_str());
+            continue;
+        }
+
+        images.push_back(p);
+
+        before += p.sourceSize;
+        raw    += (long)p.w * p.h * 4;
+    }
+
+    if(images.empty())
+    {
+        fprintf(stderr, "nothing to pack\n");
+        SDL_Quit();
+        return 1;
+    }
+
+    //the index, then the images in the same order
+    vector<unsigned char> index;
+    Uint32                offset = HEADER_SIZE;
+
+    for(int i = 0; i < (int)images.size(); i++)
+        offset += ENTRY_SIZE + (Uint32)images[i].file.size();
+
+    index.insert(index.end(), "APAK", "APAK" + 4);
+    put32(index, Archive::VERSION);
+    put32(index, (Uint32)images.size());
+    put32(index, 32);
+    put32(index, RMASK);
+    put32(index, GMASK);
+    put32(index, BMASK);
+
+    for(int i = 0; i < (int)images.size(); i++)
+    {
+        Packed& p = images[i];
+
+        put16(index, (Uint32)p.file.size());
+        index.insert(index.end(), p.file.begin(), p.file.end());
+        put16(index, p.w);
+        put16(index, p.h);
+        put32(index, offset);
+        put32(index, (Uint32)p.data.size());
+        put32(index, p.sourceSize);
+        put32(index, p.sourceTime);
+
+        offset += (Uint32)p.data.size();
+    }
+
+    FILE* out = fopen(name.c_str(), "wb");
+    bool  ok  = out && fwrite(&index[0], 1, index.size(), out) == index.size();
+
+    for(int i = 0; ok && i < (int)images.size(); i++)
+    {
+        vector<unsigned char>& d = images[i].data;
+        ok = fwrite(&d[0], 1, d.size(), out) == d.size();
+    }
+
+    if(out)
+        ok = fclose(out) == 0 && ok;
+
+    SDL_Quit();
+
+    if(!ok)
+    {
+        fprintf(stderr, "cannot write %s\n", name.c_str());
+        return 1;
+    }
+
+    printf("%d images: %ld KB as .bmp files, %ld KB of pixels, %ld KB packed\n",
+           (int)images.size(), before / 1024, raw / 1024, (long)offset / 1024);
+
+    return 0;
+}
@@ -0,0 +1,299 @@
+/*******************************************************************************
+ Filename:                  PackAtlas.cpp
+
+ Description:               Build step that packs the small sprites the game
+                            draws into one atlas image, so they load with a
+                            single file read and share one surface and color
+                            key. Every .bmp named in the .gel files given is
+                            packed, along with any .bmp given directly (the
+                            sprites the code loads itself). Images bigger
+                            than the limit on either side, such as
+                            backgrounds and the 1280x720 sheets walls and
+                            pigs are cut from, are left on their own.
+
+                            Sprites are placed tallest first on shelves
+                            across the atlas, a pixel of the transparent
+                            color between them. Writes <name>.bmp and
+                            <name>.atlas, the table TextureCache::loadAtlas
+                            reads: the image, the number of sprites, then a
+                            line per sprite with its file, x, y, w, h, and
+                            the size and modification time of its file, so a
+                            sprite edited since is loaded from its file.
+
+                            Build from the repository root:
+                            g++ -O2 -I. tools/PackAtlas.cpp Archive.cpp \
+                                Lz4.cpp -lSDL
+
+                            Usage, from the directory the game runs in:
+                            packatlas [-o name] [-w width] [-m max] \
+                                *.gel Slingshot.bmp Monkey.bmp AngryBird.bmp \
+                                UFO.bmp Resume.bmp Reset.bmp Exit.bmp \
+                                Unpause.bmp
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <SDL/SDL.h>
+
+#include "Archive.h"
+
+using namespace std;
+
+//the color drawn as transparent in every sprite, as in TextureCache
+const Uint8 KEY_R = 0xFF;
+const Uint8 KEY_G = 0xAE;
+const Uint8 KEY_B = 0xC9;
+
+const int DEFAULT_WIDTH = 1024;
+const int DEFAULT_MAX   = 256;      //largest sprite packed, either side
+const int PADDING       = 1;
+
+struct Packed
+{
+    string          file;
+    SDL_Surface*    image;
+    SDL_Rect        rect;
+    Uint32          sourceSize;
+    Uint32          sourceTime;
+};
+
+/*******************************************************************************
+ Name:              taller
+ Description:       Packing order: tallest first, then widest, then by name
+                    so the atlas is the same on every run
+ ******************************************************************************/
+static bool taller(const Packed& a, const Packed& b)
+{
+    if(a.image->h != b.image->h)    return a.image->h > b.image->h;
+    if(a.image->w != b.image->w)    return a.image->w > b.image->w;
+    return a.file < b.file;
+}
+
+static bool endsWith(const string& s, const char* end)
+{
+    size_t n = strlen(end);
+
+    return s.size() >= n && s.compare(s.size() - n, n, end) == 0;
+}
+
+/*******************************************************************************
+ Name:              scanLevel
+ Description:       Adds every .bmp a level names
+
+ Output:
+    returns         false if the level could not be read
+ ******************************************************************************/
+static bool scanLevel(const char* level, set<string>& files)
+{
+    ifstream inFile(level);
+    string   word;
+
+    if(!inFile)
+        return false;
+
+    while(inFile >> word)
+    {
+        if(endsWith(word, ".bmp"))
+            files.insert(word);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ Name:              place
+ Description:       Lays the sprites out on shelves, tallest first
+
+ Input:
+    width           Width of the atlas
+
+ Output:
+    sprites         Sorted, each with its rect in the atlas
+    returns         Height of the atlas
+ ******************************************************************************/
+static int place(vector<Packed>& sprites, int width)
+{
+    int x = 0, y = 0, shelf = 0;
+
+    sort(sprites.begin(), sprites.end(), taller);
+
+    for(int i = 0; i < (int)sprites.size(); i++)
+    {
+        SDL_Surface* s = sprites[i].image;
+
+        if(x + s->w > width)
+        {
+            x = 0;
+            y += shelf + PADDING;
+            shelf = 0;
+        }
+
+        sprites[i].rect.x = x;
+        sprites[i].rect.y = y;
+        sprites[i].rect.w = s->w;
+        sprites[i].rect.h = s->h;
+
+        x += s->w + PADDING;
+        shelf = max(shelf, s->h);
+    }
+
+    return y + shelf;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: packatlas [-o name] [-w width] [-m max] file.gel|file.bmp ...\n"
+                    "  -o name   writes name.bmp and name.atlas (default: Sprites)\n"
+                    "  -w width  width of the atlas (default: %d)\n"
+                    "  -m max    largest sprite packed, either side (default: %d)\n",
+                    DEFAULT_WIDTH, DEFAULT_MAX);
+}
+
+int main(int argc, char* argv[])
+{
+    string      name  = "Sprites";
+    int         width = DEFAULT_WIDTH;
+    int         limit = DEFAULT_MAX;
+    set<string> files;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "-o") && i + 1 < argc)
+            name = argv[++i];
+        else if(!strcmp(argv[i], "-w") && i + 1 < argc)
+            width = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-m") && i + 1 < argc)
+            limit = atoi(argv[++i]);
+        else if(argv[i][0] == '-')
+        {
+            usage();
+            return 2;
+        }
+        else if(endsWith(argv[i], ".bmp"))
+            files.insert(argv[i]);
+        else if(!scanLevel(argv[i], files))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if(files.empty() || width < 1 || limit < 1)
+    {
+        usage();
+        return 2;
+    }
+
+    SDL_Init(0);
+
+    vector<Packed> sprites;
+    long           before = 0;
+
+    for(set<string>::iterator it = files.begin(); it != files.end(); ++it)
+    {
+        Packed       p;
+        SDL_Surface* s = NULL;
+
+        if(Archive::stamp(it->c_str(), p.sourceSize, p.sourceTime))
+            s = SDL_LoadBMP(it->c_str());
+
+        if(!s)
+        {
+            fprintf(stderr, "  %s: cannot load, left out\n", it->c_str());
+            continue;
+        }
+
+        if(s->w > limit || s->h > limit || s->w > width)
+        {
+            printf("  %s: %dx%d, left on its own\n", it->c_str(), s->w, s->h);
+            SDL_FreeSurface(s);
+            continue;
+        }
+
+        p.file  = *it;
+        p.image = s;
+        sprites.push_back(p);
+
+        before += (long)s->pitch * s->h;
+    }
+
+    if(sprites.empty())
+    {
+        fprintf(stderr, "nothing to pack\n");
+        SDL_Quit();
+        return 1;
+    }
+
+    int height = place(sprites, width);
+
+    SDL_PixelFormat* f = sprites[0].image->format;
+    SDL_Surface*     atlas = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height,
+                                                  f->BitsPerPixel, f->Rmask,
+                                                  f->Gmask, f->Bmask, 0);
+
+    if(!atlas)
+    {
+        fprintf(stderr, "%s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    //the gaps are transparent
+    SDL_FillRect(atlas, NULL, SDL_MapRGB(atlas->format, KEY_R, KEY_G, KEY_B));
+
+    for(int i = 0; i < (int)sprites.size(); i++)
+    {
+        SDL_Rect loc = sprites[i].rect;
+        SDL_BlitSurface(sprites[i].image, NULL, atlas, &loc);
+    }
+
+    string image = name + ".bmp";
+    string table = name + ".atlas";
+
+    if(SDL_SaveBMP(atlas, image.c_str()) < 0)
+    {
+        fprintf(stderr, "cannot write %s\n", image.c_str());
+        SDL_Quit();
+        return 1;
+    }
+
+    FILE* out = fopen(table.c_str(), "w");
+
+    if(!out)
+    {
+        fprintf(stderr, "cannot write %s\n", table.c_str());
+        SDL_Quit();
+        return 1;
+    }
+
+    fprintf(out, "%s\n%d\n", image.c_str(), (int)sprites.size());
+
+    for(int i = 0; i < (int)sprites.size(); i++)
+    {
+        SDL_Rect& r = sprites[i].rect;
+        fprintf(out, "%s %d %d %d %d %u %u\n", sprites[i].file.c_str(),
+                r.x, r.y, r.w, r.h, sprites[i].sourceSize, sprites[i].sourceTime);
+    }
+
+    fclose(out);
+
+    long after = (long)atlas->pitch * atlas->h;
+
+    printf("%d sprites in %dx%d: %ld KB as %d images, %ld KB as one\n",
+           (int)sprites.size(), width, height, before / 1024,
+           (int)sprites.size(), after / 1024);
+
+    for(int i = 0; i < (int)sprites.size(); i++)
+        SDL_FreeSurface(sprites[i].image);
+    SDL_FreeSurface(atlas);
+
+    SDL_Quit();
+
+    return 0;
+}
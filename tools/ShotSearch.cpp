@@ -0,0 +1,420 @@
+/*******************************************************************************
+ Filename:                  ShotSearch.cpp
+
+ Description:               Level tuning tool. For each .gel file given,
+                            searches launch angle and power for the fewest
+                            birds that clear the level, and prints a
+                            difficulty histogram: how much of the launch space
+                            kills how many pigs with the first bird.
+
+                            Each bird is found coarse to fine: a grid over
+                            angle and power, then a few rounds of finer grids
+                            around the best shots. The best few partial
+                            solutions are carried to the next bird (a beam
+                            search). Simulations run in batches on a
+                            ThreadPool, each in its own Simulation with its
+                            own Room and World, so results do not depend on
+                            the number of threads.
+
+                            Build from the repository root:
+                            g++ -O2 -I. tools/ShotSearch.cpp $(ls *.cpp | grep -v \
+                                -e Main.cpp -e Game.cpp -e StateEngine.cpp \
+                                -e GraphicsEngine.cpp -e ControlEngine.cpp \
+                                -e AudioEngine.cpp -e PauseButton.cpp) \
+                                -lSDL -lSDL_ttf -lSDL_mixer
+
+                            Usage:
+                            shotsearch [-j threads] [-w beam] level.gel ...
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <SDL/SDL.h>
+
+#include "Simulation.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+//launch space, as far as the sling can be pulled back (Sling::handle)
+const double MIN_ANGLE      = -20;      //degrees above horizontal
+const double MAX_ANGLE      = 80;
+const double MIN_POWER      = 4;        //pixels per tick
+const double MAX_POWER      = 36;
+
+const int    COARSE_ANGLES  = 21;
+const int    COARSE_POWERS  = 9;
+const int    REFINE_ROUNDS  = 3;
+const int    REFINE_KEEP    = 3;        //shots refined per partial solution
+const int    DEFAULT_BEAM   = 3;
+const int    HIST_WIDTH     = 40;
+
+typedef vector<Vect> Launches;
+
+struct Outcome
+{
+    Launches    launches;
+    SimResult   result;
+};
+
+static int numSims = 0;
+
+/*******************************************************************************
+ Name:              better
+ Description:       Ranks outcomes: a win first, then more pigs, fewer birds,
+                    a higher score and a quicker finish
+ ******************************************************************************/
+static bool better(const Outcome& p, const Outcome& q)
+{
+    const SimResult& a = p.result;
+    const SimResult& b = q.result;
+
+    if(a.won != b.won)                  return a.won;
+    if(a.pigsKilled != b.pigsKilled)    return a.pigsKilled > b.pigsKilled;
+    if(a.birdsUsed != b.birdsUsed)      return a.birdsUsed < b.birdsUsed;
+    if(a.score != b.score)              return a.score > b.score;
+    return a.ticks < b.ticks;
+}
+
+typedef pair<Outcome, pair<double, double> > Placed;     //outcome, angle, power
+
+static bool betterPlaced(const Placed& p, const Placed& q)
+{
+    return better(p.first, q.first);
+}
+
+/*******************************************************************************
+ Name:              shotFor
+ Description:       Launch velocity for an angle and power. Projectiles take
+                    whole pixels per tick, so the shot is rounded here and
+                    shots that round the same are only simulated once.
+ ******************************************************************************/
+static Vect shotFor(double angle, double power)
+{
+    double a = angle * M_PI / 180;
+
+    return Vect(floor(power * cos(a) + .5), floor(-power * sin(a) + .5));
+}
+
+/*******************************************************************************
+ Class BatchTask
+ Description:       Plays one launch sequence per index, each in a fresh
+                    Simulation so no state is shared between threads
+ ******************************************************************************/
+class BatchTask : public ThreadTask
+{
+    public:
+        const char*         level;
+        vector<Launches>*   jobs;
+        vector<SimResult>*  results;
+
+        void runTask(int i)
+        {
+            Simulation sim;
+            (*results)[i] = sim.run(level, (*jobs)[i]);
+        }
+};
+
+/*******************************************************************************
+ Name:              runBatch
+ Description:       Plays every launch sequence from the start of the level
+
+ Input:
+    level           The .gel file
+    jobs            Launch sequences
+    pool            Threads to spread them over
+
+ Output:
+    results         One per job, in job order
+ ******************************************************************************/
+static void runBatch(const char* level, vector<Launches>& jobs,
+                     vector<SimResult>& results, ThreadPool& pool)
+{
+    BatchTask task;
+
+    results.resize(jobs.size());
+    numSims += (int)jobs.size();
+
+    task.level   = level;
+    task.jobs    = &jobs;
+    task.results = &results;
+
+    pool.run(&task, (int)jobs.size());
+}
+
+/*******************************************************************************
+ Name:              nextBird
+ Description:       Searches the shot that follows each partial solution in
+                    the beam, coarse to fine
+
+ Input:
+    level           The .gel file
+    beam            Partial solutions to extend
+    pool            Threads to simulate on
+
+ Output:
+    found           Every sequence simulated, with its outcome
+    firstShots      Outcomes of the coarse grid, for the histogram (only
+                    filled in when the beam holds the empty solution)
+ ******************************************************************************/
+static void nextBird(const char* level, vector<Launches>& beam, ThreadPool& pool,
+                     vector<Outcome>& found, vector<SimResult>& firstShots)
+{
+    int num = (int)beam.size();
+
+    //shots tried after each partial solution, so none is simulated twice
+    vector< set< pair<int, int> > > tried(num);
+    vector< vector<Outcome> >       best(num);
+
+    double dAngle = (MAX_ANGLE - MIN_ANGLE) / (COARSE_ANGLES - 1);
+    double dPower = (MAX_POWER - MIN_POWER) / (COARSE_POWERS - 1);
+
+    //angle and power of the shots to simulate, per partial solution
+    vector< vector< pair<double, double> > > grid(num);
+
+    for(int b = 0; b < num; b++)
+        for(int i = 0; i < COARSE_ANGLES; i++)
+            for(int j = 0; j < COARSE_POWERS; j++)
+                grid[b].push_back(make_pair(MIN_ANGLE + i * dAngle, MIN_POWER + j * dPower));
+
+    for(int round = 0; round <= REFINE_ROUNDS; round++)
+    {
+        vector<Launches> jobs;
+        vector<int>      owner;
+        vector< pair<double, double> > at;
+
+        for(int b = 0; b < num; b++)
+        {
+            for(int k = 0; k < (int)grid[b].size(); k++)
+            {
+                double angle = grid[b][k].first;
+                double power = grid[b][k].second;
+
+                if(angle < MIN_ANGLE || angle > MAX_ANGLE ||
+                   power < MIN_POWER || power > MAX_POWER)
+                    continue;
+
+                Vect v = shotFor(angle, power);
+
+                if(!tried[b].insert(make_pair((int)v.x, (int)v.y)).second)
+                    continue;
+
+                jobs.push_back(beam[b]);
+                jobs.back().push_back(v);
+                owner.push_back(b);
+                at.push_back(grid[b][k]);
+            }
+        }
+
+        vector<SimResult> results;
+        runBatch(level, jobs, results, pool);
+
+        if(round == 0 && num == 1 && beam[0].empty())
+            firstShots = results;
+
+        //keep the best shots of each partial solution, with where they were
+        vector< vector<Placed> > top(num);
+
+        for(int i = 0; i < (int)jobs.size(); i++)
+        {
+            Outcome o;
+            o.launches = jobs[i];
+            o.result   = results[i];
+            found.push_back(o);
+
+            top[owner[i]].push_back(make_pair(o, at[i]));
+        }
+
+        if(round == REFINE_ROUNDS)
+            break;
+
+        //halve the grid spacing around each kept shot
+        dAngle /= 2;
+        dPower /= 2;
+
+        for(int b = 0; b < num; b++)
+        {
+            vector<Placed>& t = top[b];
+
+            stable_sort(t.begin(), t.end(), betterPlaced);
+
+            grid[b].clear();
+
+            for(int i = 0; i < (int)t.size() && i < REFINE_KEEP; i++)
+                for(int da = -1; da <= 1; da++)
+                    for(int dp = -1; dp <= 1; dp++)
+                        grid[b].push_back(make_pair(t[i].second.first + da * dAngle,
+                                                    t[i].second.second + dp * dPower));
+        }
+    }
+}
+
+/*******************************************************************************
+ Name:              printHistogram
+ Description:       Share of the coarse launch grid that kills each number of
+                    pigs with the first bird
+ ******************************************************************************/
+static void printHistogram(vector<SimResult>& shots, int pigs)
+{
+    vector<int> count(pigs + 1, 0);
+
+    for(int i = 0; i < (int)shots.size(); i++)
+    {
+        int k = shots[i].pigsKilled;
+        if(k >= 0 && k <= pigs)
+            count[k]++;
+    }
+
+    printf("  first bird over %d launches:\n", (int)shots.size());
+
+    for(int k = 0; k <= pigs; k++)
+    {
+        double share = shots.empty() ? 0 : (double)count[k] / shots.size();
+        int    bar   = (int)(share * HIST_WIDTH + .5);
+
+        printf("    %2d pig%s %5.1f%% |%s\n", k, k == 1 ? " " : "s", share * 100,
+               string(bar, '#').c_str());
+    }
+}
+
+/*******************************************************************************
+ Name:              searchLevel
+ Description:       Beam search, one bird at a time, for the fewest birds
+                    that clear the level
+
+ Output:
+    returns         false if the level did not load
+ ******************************************************************************/
+static bool searchLevel(const char* level, ThreadPool& pool, int width)
+{
+    int pigs, birds;
+
+    Simulation probe;
+
+    if(!probe.load(level))
+        return false;
+
+    pigs  = probe.getResult().pigsLeft;
+    birds = probe.getBirdsLeft();
+
+    printf("%s: %d pigs, %d birds\n", level, pigs, birds);
+
+    vector<Launches>  beam(1);
+    vector<SimResult> firstShots;
+    Outcome           best;
+    bool              haveBest = false;
+
+    for(int bird = 1; bird <= birds; bird++)
+    {
+        vector<Outcome> found;
+        nextBird(level, beam, pool, found, firstShots);
+
+        stable_sort(found.begin(), found.end(), better);
+
+        if(!found.empty() && (!haveBest || better(found[0], best)))
+        {
+            best     = found[0];
+            haveBest = true;
+        }
+
+        if(haveBest && best.result.won)
+            break;
+
+        //carry the best distinct partial solutions to the next bird
+        beam.clear();
+        for(int i = 0; i < (int)found.size() && (int)beam.size() < width; i++)
+        {
+            if(found[i].result.birdsUsed == bird)
+                beam.push_back(found[i].launches);
+        }
+
+        if(beam.empty())
+            break;
+    }
+
+    if(haveBest)
+    {
+        SimResult& r = best.result;
+
+        printf("  %s with %d bird%s: %d of %d pigs, score %d, %d ticks\n",
+               r.won ? "cleared" : "best", r.birdsUsed, r.birdsUsed == 1 ? "" : "s",
+               r.pigsKilled, pigs, r.score, r.ticks);
+
+        for(int i = 0; i < (int)best.launches.size(); i++)
+            printf("    bird %d: %g,%g\n", i + 1, best.launches[i].x, best.launches[i].y);
+    }
+
+    printHistogram(firstShots, pigs);
+
+    return true;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: shotsearch [-j threads] [-w beam] level.gel ...\n"
+                    "  -j threads  threads to simulate on (default: one per core)\n"
+                    "  -w beam     partial solutions carried to the next bird\n");
+}
+
+int main(int argc, char* argv[])
+{
+    int                 threads = ThreadPool::numCores();
+    int                 width   = DEFAULT_BEAM;
+    vector<const char*> levels;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "-j") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-w") && i + 1 < argc)
+            width = atoi(argv[++i]);
+        else if(argv[i][0] == '-')
+        {
+            usage();
+            return 2;
+        }
+        else
+            levels.push_back(argv[i]);
+    }
+
+    if(levels.empty() || threads < 1 || width < 1)
+    {
+        usage();
+        return 2;
+    }
+
+    SDL_Init(SDL_INIT_TIMER);
+    Object::setHeadless(true);
+
+    ThreadPool pool(threads);
+
+    Uint32 t0 = SDL_GetTicks();
+    int    status = 0;
+
+    for(int i = 0; i < (int)levels.size(); i++)
+    {
+        if(!searchLevel(levels[i], pool, width))
+        {
+            fprintf(stderr, "cannot load %s\n", levels[i]);
+            status = 1;
+        }
+    }
+
+    double secs = (SDL_GetTicks() - t0) / 1000.0;
+
+    if(secs > 0)
+    {
+        printf("%d simulations in %.2f s on %d thread%s: %.0f/s, %.0f/s per core\n",
+               numSims, secs, threads, threads == 1 ? "" : "s",
+               numSims / secs, numSims / secs / threads);
+    }
+
+    SDL_Quit();
+
+    return status;
+}
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ Filename:                  Simulate.cpp
+
+ Description:               Command line front end for Simulation. Plays a
+                            level with no display or sound: loads the .gel
+                            file, fires each launch velocity in turn, steps to
+                            rest after each, and reports pigs killed, score
+                            and ticks. With -r the same run is repeated and
+                            the rate of simulations per second printed.
+
+                            Build from the repository root:
+                            g++ -O2 -I. tools/Simulate.cpp $(ls *.cpp | grep -v \
+                                -e Main.cpp -e Game.cpp -e StateEngine.cpp \
+                                -e GraphicsEngine.cpp -e ControlEngine.cpp \
+                                -e AudioEngine.cpp -e PauseButton.cpp) \
+                                -lSDL -lSDL_ttf -lSDL_mixer
+
+                            Usage:
+                            simulate [-r runs] [-t ticks] level.gel vx,vy ...
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <SDL/SDL.h>
+
+#include "Simulation.h"
+
+using namespace std;
+
+static void usage()
+{
+    fprintf(stderr, "usage: simulate [-r runs] [-t ticks] level.gel vx,vy ...\n"
+                    "  -r runs    repeat the run and report simulations per second\n"
+                    "  -t ticks   most ticks to wait for rest after each launch\n");
+}
+
+int main(int argc, char* argv[])
+{
+    int          runs  = 1;
+    int          limit = 0;
+    const char*  level = NULL;
+    vector<Vect> launches;
+
+    for(int i = 1; i < argc; i++)
+    {
+        double vx, vy;
+
+        if(!strcmp(argv[i], "-r") && i + 1 < argc)
+            runs = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+            limit = atoi(argv[++i]);
+        else if(!level)
+            level = argv[i];
+        else if(sscanf(argv[i], "%lf,%lf", &vx, &vy) == 2)
+            launches.push_back(Vect(vx, vy));
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    if(!level || runs < 1)
+    {
+        usage();
+        return 2;
+    }
+
+    //the timer is the only subsystem needed, no video or audio
+    SDL_Init(SDL_INIT_TIMER);
+
+    Simulation sim;
+    SimResult  r;
+
+    if(limit > 0)
+        sim.setMaxTicks(limit);
+
+    Uint32 t0 = SDL_GetTicks();
+    for(int i = 0; i < runs; i++)
+        r = sim.run(level, launches);
+    Uint32 t1 = SDL_GetTicks();
+
+    if(r.ticks < 0)
+    {
+        fprintf(stderr, "cannot load %s\n", level);
+        return 1;
+    }
+
+    printf("level:        %s\n", level);
+    printf("birds used:   %d\n", r.birdsUsed);
+    printf("pigs killed:  %d of %d%s\n", r.pigsKilled, r.pigsKilled + r.pigsLeft,
+           r.won ? " (won)" : "");
+    printf("score:        %d\n", r.score);
+    printf("ticks:        %d\n", r.ticks);
+
+    if(runs > 1)
+    {
+        double secs = (t1 - t0) / 1000.0;
+        printf("%d runs in %.2f s, %.0f simulations/s\n",
+               runs, secs, secs > 0 ? runs / secs : 0);
+    }
+
+    SDL_Quit();
+
+    return 0;
+}